@@ -0,0 +1,541 @@
+/*
+ * Sequential reader of members of tar and zip archives.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "archive_reader.hpp"
+
+#include <errno.h>
+#include <ctype.h>
+#include <string.h>
+#include <strings.h>
+#include <limits.h>
+#include <unistd.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <iterator>
+
+#define TAR_BLOCK_SIZE                  512
+#define ZIP_LOCAL_HEADER_SIGNATURE      0x04034b50
+#define ZIP_CENTRAL_HEADER_SIGNATURE    0x02014b50
+#define ZIP_END_SIGNATURE               0x06054b50
+#define ZIP64_END_SIGNATURE             0x06064b50
+#define ZIP_DESCRIPTOR_SIGNATURE        0x08074b50
+#define ZIP_LOCAL_HEADER_SIZE           30
+#define ZIP64_EXTRA_ID                  0x0001
+#define ZIP_FLAG_ENCRYPTED              0x0001
+#define ZIP_FLAG_DESCRIPTOR             0x0008
+#define ZIP_METHOD_STORED               0
+#define ZIP_METHOD_DEFLATED             8
+#define STREAM_BUFFER_SIZE              (128 * 1024)
+#define INFLATE_CHUNK_SIZE              (64 * 1024)
+#define MEMBER_SIZE_MAX                 ((uint64_t)1 << 30) // nothing like an image beyond it
+#define UNKNOWN_SIZE                    UINT64_MAX
+
+static inline uint16_t le16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static inline uint32_t le32(const uint8_t *p)
+{
+    return le16(p) | ((uint32_t)le16(p + 2) << 16);
+}
+
+static inline uint64_t le64(const uint8_t *p)
+{
+    return le32(p) | ((uint64_t)le32(p + 4) << 32);
+}
+
+// Octal digits padded by spaces or NULs, or base-256 for big numbers of GNU tar.
+static uint64_t parse_tar_number(const uint8_t *field, size_t len)
+{
+    uint64_t value = 0;
+    size_t i = 0;
+
+    if (field[0] & 0x80)
+    {
+        value = field[0] & 0x7f;
+        for (i = 1; i < len; ++i)
+        {
+            value = (value << 8) | field[i];
+        }
+
+        return value;
+    }
+
+    while (i < len && (' ' == field[i] || '\0' == field[i]))
+    {
+        ++i;
+    }
+    for (; i < len && field[i] >= '0' && field[i] <= '7'; ++i)
+    {
+        value = (value << 3) | (field[i] - '0');
+    }
+
+    return value;
+}
+
+static bool tar_checksum_ok(const uint8_t *header)
+{
+    uint64_t sum = 0;
+
+    for (int i = 0; i < TAR_BLOCK_SIZE; ++i)
+    {
+        sum += (i >= 148 && i < 156) ? ' ' : header[i]; // the checksum field itself counts as spaces
+    }
+
+    return sum == parse_tar_number(header + 148, 8);
+}
+
+// Records of a pax header are like "30 path=some/long/file/name\n", where the length covers the whole record.
+// Data is not NUL-terminated, and every read is bounded by its size.
+static bool parse_pax_path(const std::vector<uint8_t> &data, std::string &path)
+{
+    const size_t KEY_LEN = 5; // "path="
+    size_t offset = 0;
+
+    while (offset < data.size())
+    {
+        const char *record = (const char *)&data[offset];
+        size_t avail = data.size() - offset;
+        size_t len = 0;
+        size_t i = 0;
+
+        for (; i < avail && isdigit((unsigned char)record[i]); ++i)
+        {
+            len = len * 10 + (record[i] - '0');
+            if (len > avail)
+                return false;
+        }
+
+        // At least the length, a space, a key, '=' and '\n'.
+        if (0 == i || i >= avail || ' ' != record[i] || len < i + 4 || len > avail || '\n' != record[len - 1])
+            return false;
+
+        const char *key = record + i + 1;
+        const char *value_end = record + len - 1;
+
+        if ((size_t)(value_end - key) >= KEY_LEN && 0 == memcmp(key, "path=", KEY_LEN))
+        {
+            path.assign(key + KEY_LEN, value_end - key - KEY_LEN);
+            return true;
+        }
+        offset += len;
+    }
+
+    return false;
+}
+
+archive_reader_c::archive_reader_c()
+    : m_stream(nullptr)
+    , m_is_zip(false)
+    , m_ended(false)
+{
+}
+
+archive_reader_c::~archive_reader_c()
+{
+    close();
+}
+
+bool archive_reader_c::is_archive_path(const std::string &path)
+{
+    static const char *SUFFIXES[] = { ".tar", ".tar.gz", ".tgz", ".zip" };
+
+    if ("-" == path)
+        return true;
+
+    for (const char *suffix : SUFFIXES)
+    {
+        size_t len = strlen(suffix);
+
+        if (path.size() > len && 0 == strcasecmp(path.c_str() + path.size() - len, suffix))
+            return true;
+    }
+
+    return false;
+}
+
+int archive_reader_c::open(const std::string &path)
+{
+    uint8_t magic[4];
+    int fd = ("-" == path) ? dup(STDIN_FILENO) : -1;
+    int ret;
+
+    close();
+    m_stream = ("-" == path) ? ((fd >= 0) ? gzdopen(fd, "rb") : nullptr) : gzopen(path.c_str(), "rb");
+    if (nullptr == m_stream)
+    {
+        ret = errno ? -errno : -ENOMEM;
+        if (fd >= 0)
+            ::close(fd);
+        goto lbl_err;
+    }
+    gzbuffer(m_stream, STREAM_BUFFER_SIZE);
+    m_path = path;
+
+    if ((ret = read_fully(magic, sizeof(magic))) < (int)sizeof(magic))
+    {
+        ret = (ret < 0) ? ret : -EINVAL;
+        close();
+        goto lbl_err;
+    }
+    unread(magic, sizeof(magic));
+    m_is_zip = (ZIP_LOCAL_HEADER_SIGNATURE == le32(magic));
+
+    return 0;
+
+lbl_err:
+    fprintf(stderr, "*** Failed to open archive %s: %s\n", path.c_str(), strerror(-ret));
+
+    return ret;
+}
+
+void archive_reader_c::close(void)
+{
+    if (nullptr != m_stream)
+    {
+        gzclose(m_stream);
+        m_stream = nullptr;
+    }
+    m_is_zip = false;
+    m_ended = false;
+    m_pending.clear();
+}
+
+// Returns bytes read, which are less than len only at the end of stream, or a negative error code.
+int archive_reader_c::read_fully(void *buf, size_t len)
+{
+    uint8_t *dst = (uint8_t *)buf;
+    size_t done = 0;
+
+    for (; done < len && !m_pending.empty(); ++done)
+    {
+        dst[done] = m_pending.back();
+        m_pending.pop_back();
+    }
+
+    while (done < len)
+    {
+        int ret = gzread(m_stream, dst + done, (unsigned int)std::min(len - done, (size_t)INT_MAX));
+
+        if (ret < 0)
+            return -EIO;
+
+        if (0 == ret)
+            break;
+
+        done += ret;
+    }
+
+    return (int)done;
+}
+
+int archive_reader_c::skip(uint64_t len)
+{
+    uint8_t buf[4096];
+
+    while (len > 0)
+    {
+        int size = (int)std::min(len, (uint64_t)sizeof(buf));
+        int ret = read_fully(buf, size);
+
+        if (ret < size)
+            return (ret < 0) ? ret : -EPIPE;
+
+        len -= size;
+    }
+
+    return 0;
+}
+
+void archive_reader_c::unread(const uint8_t *data, size_t len)
+{
+    m_pending.insert(m_pending.end(), std::reverse_iterator<const uint8_t *>(data + len),
+        std::reverse_iterator<const uint8_t *>(data));
+}
+
+int archive_reader_c::next(std::string &name, std::vector<uint8_t> &buffer)
+{
+    int ret;
+
+    if (nullptr == m_stream || m_ended)
+        return 0;
+
+    if ((ret = m_is_zip ? next_zip(name, buffer) : next_tar(name, buffer)) < 0)
+    {
+        fprintf(stderr, "*** Failed to read archive %s%s%s: %s\n", m_path.c_str(), name.empty() ? "" : " at ",
+            name.c_str(), strerror(-ret));
+        m_ended = true;
+    }
+    else if (0 == ret)
+        m_ended = true;
+
+    return ret;
+}
+
+int archive_reader_c::next_tar(std::string &name, std::vector<uint8_t> &buffer)
+{
+    uint8_t header[TAR_BLOCK_SIZE];
+    std::string long_name; // from a GNU long name or pax header before the member
+    int ret;
+
+    while (true)
+    {
+        if ((ret = read_fully(header, sizeof(header))) < (int)sizeof(header))
+            return (ret > 0) ? -EPIPE : ret; // archives without end blocks end here
+
+        if (std::all_of(header, header + sizeof(header), [](uint8_t c) { return 0 == c; }))
+            return 0;
+
+        if (!tar_checksum_ok(header))
+            return -EBADMSG;
+
+        uint64_t size = parse_tar_number(header + 124, 12);
+        uint64_t padding = (TAR_BLOCK_SIZE - size % TAR_BLOCK_SIZE) % TAR_BLOCK_SIZE;
+        char type = header[156];
+        bool is_regular = ('0' == type || '\0' == type || '7' == type);
+
+        if (!is_regular && 'L' != type && 'x' != type)
+        {
+            if ((ret = skip(size + padding)) < 0)
+                return ret;
+            continue;
+        }
+
+        if (size > MEMBER_SIZE_MAX)
+            return -EFBIG;
+
+        buffer.resize(size);
+        if ((ret = read_fully(buffer.data(), size)) < (int)size || (ret = skip(padding)) < 0)
+            return (ret < 0) ? ret : -EPIPE;
+
+        if ('L' == type)
+        {
+            long_name.assign((const char *)buffer.data(), strnlen((const char *)buffer.data(), size));
+            continue;
+        }
+
+        if ('x' == type)
+        {
+            if (!parse_pax_path(buffer, long_name))
+                long_name.clear();
+            continue;
+        }
+
+        if (!long_name.empty())
+            name = long_name;
+        else
+        {
+            const char *prefix = (const char *)header + 345; // of ustar
+            size_t prefix_len = (0 == memcmp(header + 257, "ustar", 5)) ? strnlen(prefix, 155) : 0;
+
+            name.assign(prefix, prefix_len);
+            if (prefix_len > 0)
+                name += '/';
+            name.append((const char *)header, strnlen((const char *)header, 100));
+        }
+
+        return 1;
+    }
+}
+
+int archive_reader_c::next_zip(std::string &name, std::vector<uint8_t> &buffer)
+{
+    uint8_t header[ZIP_LOCAL_HEADER_SIZE];
+    int ret;
+
+    while (true)
+    {
+        if ((ret = read_fully(header, 4)) < 4)
+            return (ret < 0) ? ret : -EPIPE;
+
+        uint32_t signature = le32(header);
+
+        if (ZIP_CENTRAL_HEADER_SIGNATURE == signature || ZIP_END_SIGNATURE == signature
+            || ZIP64_END_SIGNATURE == signature)
+            return 0;
+
+        if (ZIP_LOCAL_HEADER_SIGNATURE != signature)
+            return -EBADMSG;
+
+        if ((ret = read_fully(header + 4, sizeof(header) - 4)) < (int)sizeof(header) - 4)
+            return (ret < 0) ? ret : -EPIPE;
+
+        uint16_t flags = le16(header + 6);
+        uint16_t method = le16(header + 8);
+        uint32_t crc = le32(header + 14);
+        uint64_t compressed_size = le32(header + 18);
+        uint64_t size = le32(header + 22);
+        uint16_t name_len = le16(header + 26);
+        uint16_t extra_len = le16(header + 28);
+        bool has_descriptor = (flags & ZIP_FLAG_DESCRIPTOR);
+        bool is_zip64 = false;
+        std::vector<uint8_t> extra(extra_len);
+
+        name.resize(name_len);
+        if ((ret = read_fully(&name[0], name_len)) < name_len || (ret = read_fully(extra.data(), extra_len)) < extra_len)
+            return (ret < 0) ? ret : -EPIPE;
+
+        for (size_t offset = 0; offset + 4 <= extra.size(); offset += 4 + le16(&extra[offset + 2]))
+        {
+            const uint8_t *field = &extra[offset + 4];
+            size_t field_len = std::min((size_t)le16(&extra[offset + 2]), extra.size() - offset - 4);
+
+            if (ZIP64_EXTRA_ID != le16(&extra[offset]))
+                continue;
+
+            is_zip64 = true;
+            if (0xffffffff == size && field_len >= 8)
+            {
+                size = le64(field);
+                field += 8;
+                field_len -= 8;
+            }
+            if (0xffffffff == compressed_size && field_len >= 8)
+                compressed_size = le64(field);
+        }
+
+        bool is_readable = !(flags & ZIP_FLAG_ENCRYPTED)
+            && (ZIP_METHOD_DEFLATED == method || (ZIP_METHOD_STORED == method && !has_descriptor));
+
+        if (!is_readable)
+        {
+            // Without sizes in local header, the next member can't be found without decompressing this one.
+            if (has_descriptor)
+                return -ENOTSUP;
+
+            if ((ret = skip(compressed_size)) < 0)
+                return ret;
+            continue;
+        }
+
+        if (!has_descriptor && size > MEMBER_SIZE_MAX)
+            return -EFBIG;
+
+        if (ZIP_METHOD_STORED == method)
+        {
+            buffer.resize(size);
+            if ((ret = read_fully(buffer.data(), size)) < (int)size)
+                return (ret < 0) ? ret : -EPIPE;
+        }
+        else if ((ret = inflate_member(has_descriptor ? UNKNOWN_SIZE : compressed_size,
+            has_descriptor ? UNKNOWN_SIZE : size, buffer)) < 0)
+            return ret;
+
+        if (has_descriptor)
+        {
+            uint8_t descriptor[24]; // with signature, and 64-bit sizes of zip64
+            size_t len = is_zip64 ? 20 : 12;
+
+            if ((ret = read_fully(descriptor, 4)) < 4)
+                return (ret < 0) ? ret : -EPIPE;
+
+            size_t offset = (ZIP_DESCRIPTOR_SIGNATURE == le32(descriptor)) ? 4 : 0; // signature is optional
+
+            if ((ret = read_fully(descriptor + 4, len + offset - 4)) < (int)(len + offset - 4))
+                return (ret < 0) ? ret : -EPIPE;
+            crc = le32(descriptor + offset);
+        }
+
+        if (crc32(0, buffer.data(), buffer.size()) != crc)
+            return -EBADMSG;
+
+        if (!name.empty() && '/' != name.back()) // not a directory
+            return 1;
+    }
+}
+
+// Sizes are UNKNOWN_SIZE if the member has a data descriptor, and inflation goes till the end of deflate stream,
+// with input read beyond it given back to the stream.
+int archive_reader_c::inflate_member(uint64_t compressed_size, uint64_t size, std::vector<uint8_t> &buffer)
+{
+    z_stream zs;
+    uint64_t remaining = compressed_size;
+    int ret = Z_OK;
+
+    memset(&zs, 0, sizeof(zs));
+    if (Z_OK != inflateInit2(&zs, -MAX_WBITS)) // raw deflate
+        return -ENOMEM;
+
+    // A spare byte for members bigger than declared, so that the end of deflate stream is always reached.
+    buffer.resize((UNKNOWN_SIZE == size) ? std::max(buffer.capacity(), (size_t)INFLATE_CHUNK_SIZE) : size + 1);
+    m_input.resize(INFLATE_CHUNK_SIZE);
+
+    while (Z_STREAM_END != ret)
+    {
+        if (0 == zs.avail_in)
+        {
+            int len = read_fully(m_input.data(), (int)std::min(remaining, (uint64_t)m_input.size()));
+
+            if (len <= 0)
+            {
+                ret = (len < 0) ? len : -EPIPE;
+                goto lbl_end;
+            }
+            zs.next_in = m_input.data();
+            zs.avail_in = len;
+            if (UNKNOWN_SIZE != remaining)
+                remaining -= len;
+        }
+
+        if (zs.total_out == buffer.size() && UNKNOWN_SIZE == size)
+        {
+            if (buffer.size() >= MEMBER_SIZE_MAX)
+            {
+                ret = -EFBIG;
+                goto lbl_end;
+            }
+            buffer.resize(std::min(buffer.size() * 2, (size_t)MEMBER_SIZE_MAX));
+        }
+        zs.next_out = buffer.data() + zs.total_out;
+        zs.avail_out = (uInt)std::min(buffer.size() - zs.total_out, (size_t)UINT_MAX);
+
+        ret = inflate(&zs, Z_NO_FLUSH);
+        if ((Z_OK != ret && Z_STREAM_END != ret && Z_BUF_ERROR != ret)
+            || (Z_BUF_ERROR == ret && 0 == zs.avail_out && UNKNOWN_SIZE != size))
+        {
+            ret = (Z_MEM_ERROR == ret) ? -ENOMEM : -EBADMSG;
+            goto lbl_end;
+        }
+    }
+
+    if (UNKNOWN_SIZE != size && zs.total_out != size)
+    {
+        ret = -EBADMSG;
+        goto lbl_end;
+    }
+    buffer.resize(zs.total_out);
+    unread(zs.next_in, zs.avail_in);
+    ret = 0;
+
+lbl_end:
+    inflateEnd(&zs);
+
+    return ret;
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Bound parsing of pax records by their data.
+ */
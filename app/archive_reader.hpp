@@ -0,0 +1,95 @@
+/*
+ * Sequential reader of members of tar and zip archives.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __ARCHIVE_READER_HPP__
+#define __ARCHIVE_READER_HPP__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+/*
+ * Members are read one by one in a single pass without seeking, so that archives can be streamed
+ * from stdin or a pipe as well as from files, and nothing is extracted to disk:
+ *   1) tar (ustar, GNU long names and pax paths), either plain or gzipped (.tar.gz, .tgz);
+ *   2) zip, with members stored or deflated, including those with data descriptors and zip64 sizes,
+ *      where local headers are walked and the central directory at the end is never needed.
+ * The format is told by contents rather than suffix. Anything but regular files is skipped.
+ */
+class archive_reader_c
+{
+public:
+    archive_reader_c();
+
+    ~archive_reader_c();
+
+public:
+    // By suffix, or "-" for stdin, for picking archives out of image paths.
+    static bool is_archive_path(const std::string &path);
+
+    // Path "-" means stdin.
+    int open(const std::string &path);
+
+    void close(void);
+
+    // Reads contents of the next regular file into buffer, which is resized within its capacity if possible,
+    // so that a buffer reused across calls is allocated only for the biggest member.
+    // Returns 1 if read, 0 at the end of archive, or a negative error code.
+    int next(std::string &name, std::vector<uint8_t> &buffer);
+
+    const std::string& path(void) const
+    {
+        return m_path;
+    }
+
+private:
+    int read_fully(void *buf, size_t len);
+
+    int skip(uint64_t len);
+
+    void unread(const uint8_t *data, size_t len);
+
+    int next_tar(std::string &name, std::vector<uint8_t> &buffer);
+
+    int next_zip(std::string &name, std::vector<uint8_t> &buffer);
+
+    int inflate_member(uint64_t compressed_size, uint64_t size, std::vector<uint8_t> &buffer);
+
+private:
+    std::string m_path;
+    gzFile m_stream; // transparent to contents which are not gzipped
+    bool m_is_zip;
+    bool m_ended;
+    std::vector<uint8_t> m_pending; // read ahead but not consumed, in reverse order
+    std::vector<uint8_t> m_input; // of inflation
+};
+
+#endif /* #ifndef __ARCHIVE_READER_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ */
@@ -0,0 +1,140 @@
+/*
+ * Decoder-independent barcode info.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "barcode_info.hpp"
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <stdexcept>
+
+#include <ZXing/Result.h>
+
+#define REPLACEMENT_CHARACTER           0xFFFD
+
+std::string wstring_to_utf8(const std::wstring &wstr)
+{
+    std::string utf8;
+
+    utf8.reserve(wstr.size());
+    for (size_t i = 0; i < wstr.size(); ++i)
+    {
+        uint32_t code = (uint32_t)wstr[i];
+
+        // Where wchar_t is UTF-16, code points beyond BMP come in surrogate pairs.
+        if (code >= 0xD800 && code <= 0xDBFF && i + 1 < wstr.size()
+            && (uint32_t)wstr[i + 1] >= 0xDC00 && (uint32_t)wstr[i + 1] <= 0xDFFF)
+            code = 0x10000 + ((code - 0xD800) << 10) + ((uint32_t)wstr[++i] - 0xDC00);
+        else if ((code >= 0xD800 && code <= 0xDFFF) || code > 0x10FFFF)
+            code = REPLACEMENT_CHARACTER; // as QString did
+
+        if (code < 0x80)
+            utf8 += (char)code;
+        else if (code < 0x800)
+        {
+            utf8 += (char)(0xC0 | (code >> 6));
+            utf8 += (char)(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000)
+        {
+            utf8 += (char)(0xE0 | (code >> 12));
+            utf8 += (char)(0x80 | ((code >> 6) & 0x3F));
+            utf8 += (char)(0x80 | (code & 0x3F));
+        }
+        else
+        {
+            utf8 += (char)(0xF0 | (code >> 18));
+            utf8 += (char)(0x80 | ((code >> 12) & 0x3F));
+            utf8 += (char)(0x80 | ((code >> 6) & 0x3F));
+            utf8 += (char)(0x80 | (code & 0x3F));
+        }
+    }
+
+    return utf8;
+}
+
+bool parse_barcode_formats(const std::string &names, ZXing::BarcodeFormats &formats)
+{
+    if (names.empty())
+    {
+        formats = ZXing::BarcodeFormat::Any;
+        return true;
+    }
+
+    try
+    {
+        formats = ZXing::BarcodeFormatsFromString(names);
+    }
+    catch (const std::exception &e)
+    {
+        fprintf(stderr, "*** Invalid barcode formats: %s: %s\n", names.c_str(), e.what());
+        return false;
+    }
+
+    return true;
+}
+
+barcode_info_t make_barcode_info(const ZXing::Result &result, float pos_scale/* = 1.0f*/)
+{
+    const auto &pos = result.position();
+    barcode_info_t info;
+
+    info.status = result.status();
+    info.format = result.format();
+    info.orientation = result.orientation();
+    info.bits = result.numBits();
+    info.text = wstring_to_utf8(result.text());
+    info.ec_level = wstring_to_utf8(result.ecLevel());
+    info.position[0] = cv::Point(pos.topLeft().x * pos_scale, pos.topLeft().y * pos_scale);
+    info.position[1] = cv::Point(pos.topRight().x * pos_scale, pos.topRight().y * pos_scale);
+    info.position[2] = cv::Point(pos.bottomRight().x * pos_scale, pos.bottomRight().y * pos_scale);
+    info.position[3] = cv::Point(pos.bottomLeft().x * pos_scale, pos.bottomLeft().y * pos_scale);
+
+    return info;
+}
+
+barcode_info_t make_barcode_info(ZXing::DecodeStatus status)
+{
+    barcode_info_t info = {};
+
+    info.status = status;
+    info.format = ZXing::BarcodeFormat::None;
+
+    return info;
+}
+
+void map_barcode_position(barcode_info_t &info, const cv::Point &offset, float scale)
+{
+    for (auto &p : info.position)
+    {
+        p = cv::Point((p.x + offset.x) * scale, (p.y + offset.y) * scale);
+    }
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Add map_barcode_position().
+ *  03. Add parse_barcode_formats().
+ *  04. Add make_barcode_info() for results without any barcode.
+ *  05. Convert wide strings to UTF-8 natively instead of through QString.
+ */
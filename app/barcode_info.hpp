@@ -0,0 +1,76 @@
+/*
+ * Decoder-independent barcode info.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __BARCODE_INFO_HPP__
+#define __BARCODE_INFO_HPP__
+
+#include <string>
+
+#include <opencv2/core/mat.hpp>
+#include <ZXing/BarcodeFormat.h>
+#include <ZXing/DecodeStatus.h>
+
+namespace ZXing
+{
+    class Result;
+}
+
+typedef struct barcode_info
+{
+    ZXing::DecodeStatus status;
+    ZXing::BarcodeFormat format;
+    int orientation;
+    int bits;
+    std::string text; // UTF-8
+    std::string ec_level; // UTF-8
+    cv::Point position[4]; // top-left, top-right, bottom-right, bottom-left
+} barcode_info_t;
+
+std::string wstring_to_utf8(const std::wstring &wstr);
+
+// Names are separated by comma, space or "|", and an empty string means any format.
+// Returns false and leaves formats untouched if there's any invalid name.
+bool parse_barcode_formats(const std::string &names, ZXing::BarcodeFormats &formats);
+
+// Coordinates of position are multiplied by pos_scale.
+barcode_info_t make_barcode_info(const ZXing::Result &result, float pos_scale = 1.0f);
+
+// Result without any barcode, NotFound for example.
+barcode_info_t make_barcode_info(ZXing::DecodeStatus status);
+
+// Each point p of position becomes (p + offset) * scale.
+void map_barcode_position(barcode_info_t &info, const cv::Point &offset, float scale);
+
+static inline bool barcode_info_ok(const barcode_info_t &info)
+{
+    return ZXing::DecodeStatus::NoError == info.status;
+}
+
+#endif /* #ifndef __BARCODE_INFO_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Add map_barcode_position().
+ *  03. Add parse_barcode_formats().
+ *  04. Add make_barcode_info() for results without any barcode.
+ */
@@ -0,0 +1,188 @@
+/*
+ * Localization of barcode candidates, and decoding of them one by one.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "barcode_localizer.hpp"
+
+#include <math.h>
+
+#include <algorithm>
+
+#include <opencv2/imgproc.hpp>
+
+#include "decoder_engine.hpp"
+
+#define LOCALIZE_WIDTH                  640 // width of downscaled image for localization
+#define MIN_CANDIDATE_AREA_RATIO        0.001
+#define MIN_CANDIDATE_SIDE              8 // in pixels of downscaled image
+#define QUIET_ZONE_RATIO                0.2f
+#define QUIET_ZONE_MIN                  8.0f // in pixels of original image
+
+barcode_localizer_c::barcode_localizer_c(int max_candidates)
+    : m_max_candidates(max_candidates)
+{
+}
+
+barcode_localizer_c::~barcode_localizer_c()
+{
+}
+
+void barcode_localizer_c::localize(const cv::Mat &luma)
+{
+    double factor = (luma.cols > LOCALIZE_WIDTH) ? (double)LOCALIZE_WIDTH / luma.cols : 1.0;
+    std::vector<std::vector<cv::Point>> contours;
+
+    m_candidates.clear();
+
+    if (factor < 1.0)
+        cv::resize(luma, m_small, cv::Size(), factor, factor, cv::INTER_AREA);
+    else
+        m_small = luma;
+
+    // Bars and modules are where strong gradients gather.
+    cv::Sobel(m_small, m_grad_x, CV_16S, 1, 0, -1/* Scharr */);
+    cv::Sobel(m_small, m_grad_y, CV_16S, 0, 1, -1/* Scharr */);
+    cv::convertScaleAbs(m_grad_x, m_grad_x);
+    cv::convertScaleAbs(m_grad_y, m_grad_y);
+    cv::addWeighted(m_grad_x, 0.5, m_grad_y, 0.5, 0, m_mask);
+    cv::blur(m_mask, m_mask, cv::Size(7, 7));
+    cv::threshold(m_mask, m_mask, 0, 255, cv::THRESH_BINARY | cv::THRESH_OTSU);
+
+    // Closing fills gaps between bars, and opening wipes out isolated edges such as text strokes.
+    cv::morphologyEx(m_mask, m_mask, cv::MORPH_CLOSE, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(15, 15)));
+    cv::erode(m_mask, m_mask, cv::Mat(), cv::Point(-1, -1), 3);
+    cv::dilate(m_mask, m_mask, cv::Mat(), cv::Point(-1, -1), 3);
+
+    cv::findContours(m_mask, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+
+    double min_area = m_small.cols * m_small.rows * MIN_CANDIDATE_AREA_RATIO;
+
+    for (const auto &contour : contours)
+    {
+        cv::RotatedRect rect = cv::minAreaRect(contour);
+
+        if (rect.size.width < MIN_CANDIDATE_SIDE || rect.size.height < MIN_CANDIDATE_SIDE
+            || rect.size.width * rect.size.height < min_area)
+            continue;
+
+        // Back to the scale of original image, plus quiet zone.
+        float width = rect.size.width / factor;
+        float height = rect.size.height / factor;
+        cv::RotatedRect padded(cv::Point2f(rect.center.x / factor, rect.center.y / factor),
+            cv::Size2f(width + std::max(width * QUIET_ZONE_RATIO, QUIET_ZONE_MIN),
+                height + std::max(height * QUIET_ZONE_RATIO, QUIET_ZONE_MIN)), rect.angle);
+        cv::Point2f points[4]; // bottom-left, top-left, top-right, bottom-right
+        barcode_quad_t quad;
+
+        padded.points(points);
+        quad.corners[0] = points[1];
+        quad.corners[1] = points[2];
+        quad.corners[2] = points[3];
+        quad.corners[3] = points[0];
+        quad.area = padded.size.width * padded.size.height;
+        m_candidates.push_back(quad);
+    }
+
+    std::sort(m_candidates.begin(), m_candidates.end(), [](const barcode_quad_t &a, const barcode_quad_t &b) {
+        return a.area > b.area;
+    });
+    if (m_candidates.size() > (size_t)m_max_candidates)
+        m_candidates.resize(m_max_candidates);
+}
+
+static inline float distance(const cv::Point2f &a, const cv::Point2f &b)
+{
+    return hypotf(a.x - b.x, a.y - b.y);
+}
+
+static cv::Point2f transform_point(const cv::Mat &matrix, const cv::Point2f &p)
+{
+    const double *m = matrix.ptr<double>();
+    double w = m[6] * p.x + m[7] * p.y + m[8];
+
+    return cv::Point2f((m[0] * p.x + m[1] * p.y + m[2]) / w, (m[3] * p.x + m[4] * p.y + m[5]) / w);
+}
+
+barcode_info_t barcode_localizer_c::decode(const cv::Mat &image, const ZXing::DecodeHints &hints,
+    const barcode_decode_func_t &decode_func)
+{
+    cv::Mat luma;
+
+    if (1 == image.channels())
+        luma = image;
+    else
+        cv::cvtColor(image, luma, cv::COLOR_BGR2GRAY);
+
+    localize(luma);
+
+    if (m_candidates.empty())
+        return decode_func(image, hints);
+
+    std::vector<cv::Mat> inverses(m_candidates.size());
+
+    m_rectified.resize(m_candidates.size());
+    // Warping is the part worth parallelizing, while decoder of the caller is not meant to be shared among threads.
+    cv::parallel_for_(cv::Range(0, (int)m_candidates.size()), [&](const cv::Range &range) {
+        for (int i = range.start; i < range.end; ++i)
+        {
+            const auto &corners = m_candidates[i].corners;
+            float width = std::max(distance(corners[0], corners[1]), distance(corners[3], corners[2]));
+            float height = std::max(distance(corners[0], corners[3]), distance(corners[1], corners[2]));
+            cv::Point2f upright[4] = {
+                cv::Point2f(0, 0), cv::Point2f(width - 1, 0), cv::Point2f(width - 1, height - 1), cv::Point2f(0, height - 1)
+            };
+
+            cv::warpPerspective(luma, m_rectified[i], cv::getPerspectiveTransform(corners, upright),
+                cv::Size((int)width, (int)height), cv::INTER_LINEAR, cv::BORDER_REPLICATE);
+            inverses[i] = cv::getPerspectiveTransform(upright, corners);
+        }
+    });
+
+    for (size_t i = 0; i < m_candidates.size(); ++i) // the biggest candidate first
+    {
+        barcode_info_t info = decode_func(m_rectified[i], hints);
+
+        if (!barcode_info_ok(info))
+            continue;
+
+        for (auto &p : info.position)
+        {
+            p = transform_point(inverses[i], p);
+        }
+
+        return info;
+    }
+
+    return make_barcode_info(ZXing::DecodeStatus::NotFound);
+}
+
+barcode_info_t barcode_localizer_c::decode(const cv::Mat &image, const ZXing::DecodeHints &hints, decoder_c &decoder)
+{
+    return decode(image, hints, [&decoder](const cv::Mat &candidate, const ZXing::DecodeHints &candidate_hints) {
+        return decoder.decode(candidate, candidate_hints);
+    });
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Decode candidates through the decoder of caller, and the whole image if no candidate is found.
+ */
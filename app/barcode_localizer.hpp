@@ -0,0 +1,99 @@
+/*
+ * Localization of barcode candidates, and decoding of them one by one.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __BARCODE_LOCALIZER_HPP__
+#define __BARCODE_LOCALIZER_HPP__
+
+#include <vector>
+#include <functional>
+
+#include <opencv2/core/mat.hpp>
+#include <ZXing/DecodeHints.h>
+
+#include "barcode_info.hpp"
+
+class decoder_c;
+
+typedef struct barcode_quad
+{
+    cv::Point2f corners[4]; // top-left, top-right, bottom-right, bottom-left
+    float area;
+} barcode_quad_t;
+
+// Decodes an image with hints, through a decoder_c (and a deadline if any) of the caller.
+typedef std::function<barcode_info_t(const cv::Mat &, const ZXing::DecodeHints &)> barcode_decode_func_t;
+
+/*
+ * Stage 1 finds regions dense in strong gradients (bars and modules) on a downscaled luma image,
+ * by closing and opening the thresholded gradient magnitude, and returns them as quads,
+ * the biggest first.
+ * Stage 2 warps all quads (with a margin as quiet zone) into upright images of their own in parallel,
+ * and decodes them one by one, the biggest first, through the decoder of the caller until one succeeds,
+ * so that decoding cost grows with the number of labels rather than the area of image,
+ * and the engines, mode and deadline of the caller apply to candidates as well.
+ * The whole image is decoded instead if no candidate is found.
+ */
+class barcode_localizer_c
+{
+public:
+    // Localizer is disabled if max_candidates is 0.
+    barcode_localizer_c(int max_candidates);
+
+    ~barcode_localizer_c();
+
+public:
+    bool enabled(void) const
+    {
+        return m_max_candidates > 0;
+    }
+
+    // Image is either luma or BGR, and the position of result is relative to it.
+    barcode_info_t decode(const cv::Mat &image, const ZXing::DecodeHints &hints, const barcode_decode_func_t &decode_func);
+
+    barcode_info_t decode(const cv::Mat &image, const ZXing::DecodeHints &hints, decoder_c &decoder);
+
+    // Candidates of the last call to decode().
+    const std::vector<barcode_quad_t>& candidates(void) const
+    {
+        return m_candidates;
+    }
+
+private:
+    void localize(const cv::Mat &luma);
+
+private:
+    const int m_max_candidates;
+    std::vector<barcode_quad_t> m_candidates;
+    std::vector<cv::Mat> m_rectified; // of candidates
+    cv::Mat m_small;
+    cv::Mat m_grad_x;
+    cv::Mat m_grad_y;
+    cv::Mat m_mask;
+};
+
+#endif /* #ifndef __BARCODE_LOCALIZER_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Decode candidates through the decoder of caller, and the whole image if no candidate is found.
+ */
@@ -0,0 +1,118 @@
+/*
+ * C API of the embeddable scanner library (libbarcode_scanner.so).
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __BARCODE_SCANNER_H__
+#define __BARCODE_SCANNER_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Only declarations in this file are stable across versions of the library:
+ *   1) option structures begin with struct_size, which is filled in by their *_init() functions
+ *      with the size known to the caller, so that a library of a newer version never reads or writes
+ *      past them, and fields appended later keep their defaults for callers built against an older one;
+ *   2) fields are only appended to bcs_result_t, which is owned by the library;
+ *   3) layout of bcs_image_t never changes.
+ * All functions returning int return 0 (or a count) on success, or a negative errno on failure.
+ */
+#define BCS_API_VERSION                 1
+
+#define BCS_API                         __attribute__((visibility("default")))
+
+#define BCS_FOURCC(a, b, c, d)          ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+/* Pixel formats, the same FOURCCs as V4L2. Only luma plane of NV12 is read. */
+#define BCS_PIXEL_GREY                  BCS_FOURCC('G', 'R', 'E', 'Y')
+#define BCS_PIXEL_NV12                  BCS_FOURCC('N', 'V', '1', '2')
+#define BCS_PIXEL_BGR                   BCS_FOURCC('B', 'G', 'R', '3')
+
+typedef struct bcs_scanner bcs_scanner_t;
+
+typedef struct bcs_options
+{
+    size_t struct_size; /* sizeof(bcs_options_t) of caller, filled in by bcs_options_init() */
+    const char *decoders; /* separated by comma, NULL for "zxing" */
+    const char *decode_mode; /* "cascade" or "race", NULL for "cascade" */
+    const char *formats; /* names of symbologies separated by comma, NULL or "" for any */
+    int try_harder; /* non-zero by default */
+    int localize; /* at most as many candidates are located and decoded, 0 (default) to decode whole images */
+    int consensus; /* a result is emitted only after as many agreeing reads, 1 (default) to emit at once */
+} bcs_options_t;
+
+/* Caller-owned pixels, which are read in place during the call, without copying. */
+typedef struct bcs_image
+{
+    uint32_t format; /* BCS_PIXEL_* */
+    int width;
+    int height;
+    size_t stride; /* bytes per row of the first plane, 0 for rows without padding */
+    const void *pixels;
+} bcs_image_t;
+
+typedef struct bcs_result
+{
+    const char *text; /* UTF-8, valid only during the callback */
+    const char *format; /* name of symbology, valid only during the callback */
+    int x[4]; /* corners: top-left, top-right, bottom-right, bottom-left */
+    int y[4];
+    int orientation; /* in degrees */
+    uint64_t frame_seq; /* 1-based, counting images decoded */
+} bcs_result_t;
+
+/* Called on the thread of bcs_decode(), and must not call functions of the same scanner. */
+typedef void (*bcs_result_cb)(const bcs_result_t *result, void *user_data);
+
+BCS_API const char* bcs_version(void);
+
+/* Struct size is sizeof(*options) of caller. */
+BCS_API void bcs_options_init(bcs_options_t *options, size_t struct_size);
+
+/* Options may be NULL for defaults. Decoders are created here once, and kept warm till bcs_close(). */
+BCS_API int bcs_open(const bcs_options_t *options, bcs_scanner_t **scanner);
+
+BCS_API void bcs_close(bcs_scanner_t *scanner);
+
+/* Callback may be NULL to drop results. */
+BCS_API int bcs_set_result_callback(bcs_scanner_t *scanner, bcs_result_cb callback, void *user_data);
+
+/* Synchronous. Returns the number of results emitted (0 or 1). Calls from different threads are serialized,
+   since state of decoders and consensus is kept across images. Frames are captured by the caller:
+   the camera pipeline of barcode_scanner.elf (governor, preprocessing, watchdog and so on) is not part of the library. */
+BCS_API int bcs_decode(bcs_scanner_t *scanner, const bcs_image_t *image);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* #ifndef __BARCODE_SCANNER_H__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Begin option structures with struct_size.
+ *  03. Drop the source API, which duplicated the camera pipeline in a stripped-down form.
+ */
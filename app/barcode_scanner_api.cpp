@@ -0,0 +1,263 @@
+/*
+ * Implementation of the C API of the embeddable scanner library.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "barcode_scanner.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <exception>
+#include <algorithm>
+
+#include <opencv2/core/mat.hpp>
+#include <ZXing/DecodeHints.h>
+
+#include "versions.hpp"
+#include "barcode_info.hpp"
+#include "decoder_engine.hpp"
+#include "barcode_localizer.hpp"
+#include "temporal_consensus.hpp"
+#include "raw_frame.hpp"
+
+static_assert(BCS_PIXEL_GREY == RAW_FORMAT_GREY && BCS_PIXEL_NV12 == RAW_FORMAT_NV12
+    && BCS_PIXEL_BGR == RAW_FORMAT_BGR, "Pixel formats of C API must be the same as raw frames");
+
+#define BCS_STRINGIFY(x)                #x
+#define BCS_TO_STRING(x)                BCS_STRINGIFY(x)
+
+/*
+ * Everything is created once by bcs_open() and reused for each image, so that callers pay for
+ * decoder setup (and racer threads in race mode) only once.
+ * A single lock serializes decoding of images given by callers on different threads,
+ * since decoder, localizer and consensus keep state across calls.
+ */
+struct bcs_scanner
+{
+    bcs_scanner(int localize, int consensus)
+        : localizer(localize)
+        , consensus(consensus)
+        , callback(nullptr)
+        , user_data(nullptr)
+        , frame_seq(0)
+    {
+    }
+
+    decoder_c decoder;
+    barcode_localizer_c localizer;
+    temporal_consensus_c consensus;
+    ZXing::DecodeHints hints;
+    bcs_result_cb callback;
+    void *user_data;
+    uint64_t frame_seq;
+    std::mutex lock;
+};
+
+const char* bcs_version(void)
+{
+    return BCS_TO_STRING(MAJOR_VER) "." BCS_TO_STRING(MINOR_VER) "." BCS_TO_STRING(PATCH_VER);
+}
+
+// Writes defaults into the first struct_size bytes of caller, zeroing fields unknown to this version.
+template<typename T>
+static void init_sized(T *options, size_t struct_size, const T &defaults)
+{
+    if (nullptr == options || struct_size < sizeof(options->struct_size))
+        return;
+
+    memset(options, 0, struct_size);
+    memcpy(options, &defaults, std::min(struct_size, sizeof(T)));
+    options->struct_size = struct_size;
+}
+
+// Reads the first struct_size bytes of caller over defaults. Returns 0, or -EINVAL if struct_size is bogus.
+template<typename T>
+static int copy_sized(const T *options, T &result)
+{
+    if (options->struct_size < sizeof(options->struct_size))
+    {
+        fprintf(stderr, "*** Invalid struct size of options: %zu\n", options->struct_size);
+        return -EINVAL;
+    }
+
+    memcpy(&result, options, std::min(options->struct_size, sizeof(T)));
+    result.struct_size = sizeof(T);
+
+    return 0;
+}
+
+static bcs_options_t default_options(void)
+{
+    bcs_options_t options;
+
+    memset(&options, 0, sizeof(options));
+    options.struct_size = sizeof(options);
+    options.try_harder = 1;
+    options.consensus = 1;
+
+    return options;
+}
+
+void bcs_options_init(bcs_options_t *options, size_t struct_size)
+{
+    init_sized(options, struct_size, default_options());
+}
+
+int bcs_open(const bcs_options_t *caller_options, bcs_scanner_t **scanner)
+{
+    bcs_options_t merged = default_options();
+    const bcs_options_t *options = &merged;
+    ZXing::BarcodeFormats formats;
+    int ret;
+
+    if (nullptr == scanner)
+        return -EINVAL;
+
+    *scanner = nullptr;
+    if (nullptr != caller_options && (ret = copy_sized(caller_options, merged)) < 0)
+        return ret;
+
+    if (options->localize < 0 || options->consensus < 0)
+    {
+        fprintf(stderr, "*** Invalid localize or consensus option: %d, %d\n", options->localize, options->consensus);
+        return -EINVAL;
+    }
+
+    if (!parse_barcode_formats(options->formats ? options->formats : "", formats))
+    {
+        fprintf(stderr, "*** Invalid barcode formats: %s\n", options->formats);
+        return -EINVAL;
+    }
+
+    try
+    {
+        std::unique_ptr<bcs_scanner_t> result(new bcs_scanner_t(options->localize, options->consensus));
+
+        if ((ret = result->decoder.init(options->decoders ? options->decoders : "zxing",
+            options->decode_mode ? options->decode_mode : "cascade")) < 0)
+            return ret;
+
+        result->hints.setFormats(formats);
+        // Misreads of cheaper decoding are voted out by consensus, the same as the camera pipeline.
+        result->hints.setTryHarder(options->try_harder && !result->consensus.enabled());
+        *scanner = result.release();
+    }
+    catch (const std::exception &e)
+    {
+        fprintf(stderr, "*** Failed to create scanner: %s\n", e.what());
+        return -ENOMEM;
+    }
+
+    return 0;
+}
+
+void bcs_close(bcs_scanner_t *scanner)
+{
+    delete scanner;
+}
+
+int bcs_set_result_callback(bcs_scanner_t *scanner, bcs_result_cb callback, void *user_data)
+{
+    if (nullptr == scanner)
+        return -EINVAL;
+
+    std::lock_guard<std::mutex> guard(scanner->lock);
+
+    scanner->callback = callback;
+    scanner->user_data = user_data;
+
+    return 0;
+}
+
+// Image is either luma or BGR. Returns the number of results emitted, or a negative error code.
+static int decode_and_report(bcs_scanner_t *scanner, const cv::Mat &image)
+{
+    std::lock_guard<std::mutex> guard(scanner->lock);
+    barcode_info_t info;
+    std::string text;
+
+    try
+    {
+        info = scanner->localizer.enabled()
+            ? scanner->localizer.decode(image, scanner->hints, scanner->decoder)
+            : scanner->decoder.decode(image, scanner->hints);
+    }
+    catch (const std::exception &e)
+    {
+        fprintf(stderr, "*** Failed to decode image #%llu: %s\n", (unsigned long long)(scanner->frame_seq + 1), e.what());
+        return -EIO;
+    }
+
+    ++scanner->frame_seq;
+    if (!scanner->consensus.feed(info, text))
+        return 0;
+
+    if (nullptr != scanner->callback)
+    {
+        bcs_result_t result;
+
+        result.text = text.c_str();
+        result.format = ZXing::ToString(info.format);
+        for (int i = 0; i < 4; ++i)
+        {
+            result.x[i] = info.position[i].x;
+            result.y[i] = info.position[i].y;
+        }
+        result.orientation = info.orientation;
+        result.frame_seq = scanner->frame_seq;
+        scanner->callback(&result, scanner->user_data);
+    }
+
+    return 1;
+}
+
+int bcs_decode(bcs_scanner_t *scanner, const bcs_image_t *image)
+{
+    if (nullptr == scanner || nullptr == image || nullptr == image->pixels || image->width <= 0 || image->height <= 0)
+        return -EINVAL;
+
+    int type = raw_frame_mat_type(image->format);
+    size_t min_stride = raw_frame_min_stride(image->format, image->width);
+
+    if (type < 0 || (image->stride > 0 && image->stride < min_stride))
+    {
+        fprintf(stderr, "*** Invalid pixel format or stride: 0x%08x, %zu\n", image->format, image->stride);
+        return -EINVAL;
+    }
+
+    // A header over pixels of caller, which are never written to. NV12 is wrapped as its luma plane.
+    const cv::Mat frame(image->height, image->width, type, const_cast<void *>(image->pixels),
+        (image->stride > 0) ? image->stride : min_stride);
+
+    return decode_and_report(scanner, frame);
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Honor struct_size of option structures.
+ *  03. Drop the source API, which duplicated the camera pipeline in a stripped-down form.
+ */
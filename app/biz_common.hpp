@@ -31,6 +31,7 @@ typedef int (*biz_func_t)(BIZ_FUN_ARG_LIST);
 extern DECLARE_BIZ_FUN(test_camera);
 extern DECLARE_BIZ_FUN(detect_from_camera);
 extern DECLARE_BIZ_FUN(detect_from_images);
+extern DECLARE_BIZ_FUN(merge_image_results);
 
 #define AUTO_BACKEND                    "ANY"
 
@@ -61,5 +62,8 @@ int backend_name_to_code(const char *name);
  *
  * >>> 2024-05-19, Man Hung-Coeng <udc577@126.com>:
  *  01. Declare all biz functions in this file.
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Declare merge_image_results().
  */
 
@@ -18,27 +18,59 @@
 
 #include "signal_handling.h"
 
+#include <time.h>
+#include <string.h>
+
 #include <set>
+#include <algorithm>
+#include <memory>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 #include <opencv2/core/mat.hpp>
 #include <opencv2/imgproc.hpp>
+#ifndef HEADLESS
 #include <opencv2/highgui.hpp>
+#endif
 #include <ZXing/DecodeHints.h>
-#include <ZXing/ReadBarcode.h>
-#include <ZXing/Result.h>
-#include <QtCore/QString>
 
 #include "cmdline_args.hpp"
 #include "biz_common.hpp"
+#include "frame_governor.hpp"
+#include "frame_preproc.hpp"
+#include "barcode_info.hpp"
+#include "conf_file.hpp"
+#include "logger.hpp"
+#include "decoder_engine.hpp"
+#include "barcode_localizer.hpp"
+#include "quad_rescanner.hpp"
+#include "decode_deadline.hpp"
+#include "latency_histogram.hpp"
+#include "temporal_consensus.hpp"
+#include "frame_source.hpp"
+#include "thread_policy.hpp"
+#include "handoff_slot.hpp"
+#include "frame_pool.hpp"
+#include "raw_frame.hpp"
 
 #define MAX_FRAME_RATE                  30.0
 #define MAX_FRAME_RATE_FOR_GUI          15.0
 #define MAX_FRAME_WIDTH                 1920
 #define MAX_FRAME_HEIGHT                1080
+#define DISPLAY_POLL_MS                 100
+#define REOPEN_INTERVAL_MIN_MS          100
+#define REOPEN_INTERVAL_MAX_MS          2000
+
+static inline float max_frame_rate(const cmd_args_t &args)
+{
+    return args.use_gui ? MAX_FRAME_RATE_FOR_GUI : MAX_FRAME_RATE;
+}
 
 static bool validate_several_args_again(const cmd_args_t &args)
 {
-    float max_fps = args.use_gui ? MAX_FRAME_RATE_FOR_GUI : MAX_FRAME_RATE;
+    float max_fps = max_frame_rate(args);
 
     if (args.fps > max_fps && args.fps - max_fps > 0.01)
     {
@@ -46,6 +78,11 @@ static bool validate_several_args_again(const cmd_args_t &args)
         return false;
     }
 
+    ZXing::BarcodeFormats formats;
+
+    if (!parse_barcode_formats(args.formats, formats))
+        return false;
+
     if (args.width > MAX_FRAME_WIDTH)
     {
         fprintf(stderr, "*** Frame width should not be greater than %d (px)!\n", MAX_FRAME_WIDTH);
@@ -92,6 +129,11 @@ static int open_camera(const cmd_args_t &args, cv::VideoCapture &vicap)
     vicap.set(cv::CAP_PROP_FRAME_WIDTH, args.width);
     vicap.set(cv::CAP_PROP_FRAME_HEIGHT, args.height);
     vicap.set(cv::CAP_PROP_FPS, args.fps);
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 6)
+    // So that a stalled device fails reading within the watchdog timeout, instead of 10s of V4L2 by default.
+    if (args.watchdog > 0)
+        vicap.set(cv::CAP_PROP_READ_TIMEOUT_MSEC, args.watchdog);
+#endif
     if ("auto" != cv::toLowerCase(args.format))
     {
         // vicap.set(cv::CAP_PROP_FORMAT, ...); // TODO: converted from parsed_args.format
@@ -101,44 +143,215 @@ static int open_camera(const cmd_args_t &args, cv::VideoCapture &vicap)
     return EXIT_SUCCESS;
 }
 
-static ZXing::Result detect_barcode(const cv::Mat &frame)
+static int open_source(const cmd_args_t &args, std::unique_ptr<frame_source_c> &source)
 {
-    auto img_view = ZXing::ImageView(frame.data, frame.cols, frame.rows, ZXing::ImageFormat::BGR);
-    ZXing::DecodeHints hints;
-    auto result = ZXing::ReadBarcode(img_view, hints.setFormats(ZXing::BarcodeFormat::Any));
+    if ("replay" == args.source)
+    {
+        replay_source_c *replay = new replay_source_c(args.replay_speed);
+
+        source.reset(replay);
+        if (args.img_files->empty())
+        {
+            fprintf(stderr, "*** Recording file not specified!\n");
+            return -EINVAL;
+        }
+
+        return replay->open(args.img_files->front());
+    }
+
+    if ("shm" == args.source)
+    {
+        shm_source_c *shm = new shm_source_c();
+
+        source.reset(shm);
+        if (args.img_files->empty())
+        {
+            fprintf(stderr, "*** Name of shared memory not specified!\n");
+            return -EINVAL;
+        }
+
+        return shm->open(args.img_files->front());
+    }
+
+    if ("stdin" == args.source)
+    {
+        // Same frame size and format options as camera, while auto means what VideoCapture gives, i.e. BGR.
+        uint32_t format = ("auto" == cv::toLowerCase(args.format)) ? RAW_FORMAT_BGR : raw_format_from_name(args.format);
+        pipe_source_c *pipe = new pipe_source_c(format, args.width, args.height, args.fps);
+
+        source.reset(pipe);
+
+        return pipe->open(args.img_files->empty() ? "-" : args.img_files->front());
+    }
+
+    camera_source_c *camera = new camera_source_c([&args](cv::VideoCapture &vicap) {
+        return open_camera(args, vicap);
+    });
+
+    source.reset(camera);
+
+    return camera->open();
+}
+
+typedef struct captured_frame
+{
+    cv::Mat frame;
+    int64_t timestamp_ns; // of steady clock
+} captured_frame_t;
+
+static inline int64_t steady_clock_ns(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool capture_frame(frame_source_c &source, frame_recorder_c &recorder, captured_frame_t &captured)
+{
+    if (!source.read(captured.frame) || captured.frame.empty())
+        return false;
+
+    captured.timestamp_ns = source.timestamp_ns();
+    if (captured.timestamp_ns <= 0)
+        captured.timestamp_ns = steady_clock_ns();
+
+    if (recorder.is_open() && recorder.write(captured.frame, captured.timestamp_ns) < 0)
+    {
+        log_error("Failed to record frame, recording stopped!");
+        recorder.close();
+    }
+
+    return true;
+}
+
+static void report_capture_failure(const frame_source_c &source)
+{
+    if (source.exhausted())
+        fprintf(stderr, "End of input\n");
+    else
+        log_error("Failed to capture frame!");
+}
+
+/*
+ * The frame is preprocessed into luma if needed, and the candidate region is tried first.
+ * If localization is enabled, the localized candidates are decoded (or the whole frame if none is found).
+ * Either way decoding goes in escalating stages if a deadline is specified.
+ * The position of result is mapped back to the frame before being resized by scale.
+ */
+static barcode_info_t detect_barcode(const cv::Mat &frame, float scale, decoder_c &decoder, decode_deadline_c &deadline,
+    const ZXing::DecodeHints &hints, frame_preprocessor_c &preprocessor, barcode_localizer_c &localizer, cv::Mat &luma)
+{
+    if (localizer.enabled())
+    {
+        // ROI assist is superseded by localization, while contrast enhancement still helps.
+        if (preprocessor.enabled())
+            preprocessor.apply(frame, luma);
+
+        auto info = localizer.decode(preprocessor.enabled() ? luma : frame, hints,
+            [&decoder, &deadline](const cv::Mat &candidate, const ZXing::DecodeHints &candidate_hints) {
+                return deadline.decode(decoder, candidate, candidate_hints);
+            });
+
+        map_barcode_position(info, cv::Point(0, 0), 1.0f / scale);
+
+        return info;
+    }
+
+    if (!preprocessor.enabled())
+    {
+        auto info = deadline.decode(decoder, frame, hints);
+
+        map_barcode_position(info, cv::Point(0, 0), 1.0f / scale);
 
-    return result;
+        return info;
+    }
+
+    cv::Rect roi = preprocessor.apply(frame, luma);
+    bool is_partial = (roi.width < luma.cols || roi.height < luma.rows);
+    auto info = deadline.decode(decoder, is_partial ? luma(roi) : luma, hints);
+
+    if (is_partial && !barcode_info_ok(info))
+    {
+        roi = cv::Rect(0, 0, luma.cols, luma.rows);
+        info = deadline.decode(decoder, luma, hints);
+    }
+    map_barcode_position(info, roi.tl(), 1.0f / scale);
+
+    return info;
 }
 
-static bool do_nothing_to_frame(const std::string &window_name, ZXing::Result &barcode_info, cv::Mat &frame)
+// Static ROI of tuning parameters clipped to the frame, or the whole frame if not specified.
+static cv::Rect clip_static_roi(const int (&roi)[4], const cv::Mat &frame)
+{
+    cv::Rect whole(0, 0, frame.cols, frame.rows);
+
+    if (roi[2] <= 0 || roi[3] <= 0)
+        return whole;
+
+    cv::Rect clipped = cv::Rect(roi[0], roi[1], roi[2], roi[3]) & whole;
+
+    return clipped.empty() ? whole : clipped;
+}
+
+/*
+ * Everything here takes effect on the fly, the camera is never reopened.
+ * Formats are left as they were if invalid.
+ */
+static void apply_tuning_params(const tuning_params_t &params, const tuning_params_t *old_params,
+    double source_fps, frame_governor_c &governor, ZXing::DecodeHints &hints)
+{
+    ZXing::BarcodeFormats formats;
+
+    if ((nullptr == old_params || params.formats != old_params->formats)
+        && parse_barcode_formats(params.formats, formats))
+        hints.setFormats(formats);
+
+    if (nullptr == old_params || params.detect_threads != old_params->detect_threads)
+        cv::setNumThreads((params.detect_threads > 0) ? params.detect_threads : -1); // -1: default of OpenCV
+
+    if ((nullptr == old_params) ? (params.fps != source_fps) : (params.fps != old_params->fps))
+    {
+        // Applied to device by capture thread, once requested through take_fps_change() in the loop.
+        governor.set_max_fps(params.fps);
+    }
+
+    fprintf(stderr, "Tuning: formats=%s threads=%d dedup_window=%d roi=%d,%d,%d,%d fps=%.1f\n",
+        params.formats.empty() ? "Any" : params.formats.c_str(), params.detect_threads, params.dedup_window,
+        params.roi[0], params.roi[1], params.roi[2], params.roi[3], params.fps);
+}
+
+static bool do_nothing_to_frame(const std::string &window_name, const barcode_info_t &barcode_info, cv::Mat &frame)
 {
     return true;
 }
 
-static bool mark_and_display_frame(const std::string &window_name, ZXing::Result &barcode_info, cv::Mat &frame)
+#ifndef HEADLESS
+// Marks are drawn on a copy, since frames may live in memory shared with other processes (the shm source),
+// or in buffers reused by the source.
+static bool mark_and_display_frame(const std::string &window_name, const barcode_info_t &barcode_info, cv::Mat &frame)
 {
     const int ESC_KEY_CODE = 27;
+    cv::Mat marked = frame;
 
-    if (ZXing::DecodeStatus::NoError == barcode_info.status())
+    if (barcode_info_ok(barcode_info))
     {
-        const auto &pos = barcode_info.position();
-        const auto &top_left = pos.topLeft();
-        const auto &bottom_right = pos.bottomRight();
-        auto center = ZXing::Position::Point(
+        const auto &pos = barcode_info.position;
+        const auto &top_left = pos[0];
+        const auto &bottom_right = pos[2];
+        auto center = cv::Point(
             std::min(top_left.x, bottom_right.x) + abs(bottom_right.x - top_left.x) / 2,
             std::min(top_left.y, bottom_right.y) + abs(bottom_right.y - top_left.y) / 2
         );
         const cv::Scalar color(0, 0, 255);
         const int thickness = 2;
 
-        for (const auto &p : { top_left, pos.topRight(), pos.bottomLeft(), bottom_right, center })
+        marked = frame.clone();
+        for (const auto &p : { top_left, pos[1], pos[3], bottom_right, center })
         {
-            cv::drawMarker(frame, cv::Point(p.x, p.y), color, cv::MarkerTypes::MARKER_DIAMOND,
-                /* markerSize = */20, thickness);
+            cv::drawMarker(marked, p, color, cv::MarkerTypes::MARKER_DIAMOND, /* markerSize = */20, thickness);
         }
     }
 
-    cv::imshow(window_name, frame);
+    cv::imshow(window_name, marked);
 
     // NOTE: The waitKey() is necessary for HighGUI to perform some housekeeping tasks.
     //       Without it, the image won't display and the window might lock up.
@@ -147,59 +360,512 @@ static bool mark_and_display_frame(const std::string &window_name, ZXing::Result
 
     return true;
 }
+#endif
 
-DECLARE_BIZ_FUN(detect_from_camera)
+typedef struct decoded_frame
 {
-    cv::VideoCapture vicap;
-    int ret = validate_several_args_again(parsed_args) ? open_camera(parsed_args, vicap) : -EINVAL;
+    cv::Mat frame;
+    barcode_info_t info;
+} decoded_frame_t;
 
-    if (ret < 0)
-        return ret;
+/*
+ * Capture, decode and display run on threads of their own, handing frames over through single slots:
+ *   1) capture thread reads (and records) every frame, and for live sources replaces the frame
+ *      not taken by decode thread yet, so that decoding always works on the latest one;
+ *   2) decode thread owns everything about detection, and hands results over to display thread
+ *      in the same way, so that a slow window never holds up decoding;
+ *   3) display thread, which is the calling thread as HighGUI requires, watches for signals and Esc key.
+ * The device is touched by capture thread only, which applies FPS changes requested by decode thread.
+ * With a watchdog, capture thread reopens the device in place once reading fails (or times out),
+ * while decoding goes on with everything warm, and display thread reports stalls of reading.
+ * Each frame carries the capture time stamped by the source (or the moment reading returns if unknown),
+ * against which latency of output is measured.
+ */
+class camera_pipeline_c
+{
+public:
+    camera_pipeline_c(const cmd_args_t &args, const conf_file_t &conf, frame_source_c &source,
+        frame_recorder_c &recorder, const thread_policies_t &policies, const frame_pool_c *pool);
+
+public:
+    // Runs until interrupted or out of frames. Returns 0 or a negative error code.
+    int run(void);
+
+private:
+    void capture_routine(void);
+
+    void decode_routine(void);
+
+    void display_routine(void);
+
+    void stop(void);
+
+    bool reopen_source(float fps);
+
+    void dump_thread_usage(FILE *stream);
+
+private:
+    const cmd_args_t &m_args;
+    const conf_file_t &m_conf;
+    frame_source_c &m_source;
+    frame_recorder_c &m_recorder;
+    const frame_pool_c *m_pool; // null if disabled
+    thread_policies_t m_policies;
+    const double m_source_fps;
+    handoff_slot_c<captured_frame_t> m_captured;
+    handoff_slot_c<decoded_frame_t> m_decoded;
+    std::atomic<bool> m_stopping;
+    std::atomic<float> m_pending_fps; // 0 if there's no change
+    std::atomic<uint64_t> m_dropped_count;
+    std::atomic<uint64_t> m_reopen_count;
+    std::atomic<double> m_last_recovery_ms;
+    std::atomic<int64_t> m_last_frame_ms; // of steady clock, 0 if recovering or not started
+    std::atomic<int> m_ret;
+    std::mutex m_lock; // of fields below
+    pthread_t m_threads[THREAD_ROLE_COUNT];
+    double m_last_cpu_seconds[THREAD_ROLE_COUNT];
+    std::chrono::steady_clock::time_point m_last_usage_time;
+};
+
+camera_pipeline_c::camera_pipeline_c(const cmd_args_t &args, const conf_file_t &conf, frame_source_c &source,
+    frame_recorder_c &recorder, const thread_policies_t &policies, const frame_pool_c *pool)
+    : m_args(args)
+    , m_conf(conf)
+    , m_source(source)
+    , m_recorder(recorder)
+    , m_pool(pool)
+    , m_source_fps(source.get_fps())
+    , m_captured(!source.live())
+    , m_decoded(false)
+    , m_stopping(false)
+    , m_pending_fps(0)
+    , m_dropped_count(0)
+    , m_reopen_count(0)
+    , m_last_recovery_ms(0)
+    , m_last_frame_ms(0)
+    , m_ret(0)
+    , m_threads()
+    , m_last_cpu_seconds()
+    , m_last_usage_time(std::chrono::steady_clock::now())
+{
+    memcpy(m_policies, policies, sizeof(m_policies));
+}
 
-    cv::Mat frame;
-    std::set<std::string> barcode_items;
-    const std::string &WINDOW_NAME = "Barcode Scanner (Press Esc to exit)";
-    auto display_func = parsed_args.use_gui ? mark_and_display_frame : do_nothing_to_frame;
+int camera_pipeline_c::run(void)
+{
+    std::thread capture_thread;
+    std::thread decode_thread;
 
-    fprintf(stderr, "Scanner started, press Ctrl+C whenever you want to stop\n");
-    cv::namedWindow(WINDOW_NAME);
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        m_threads[THREAD_ROLE_DISPLAY] = pthread_self();
+        capture_thread = std::thread(&camera_pipeline_c::capture_routine, this);
+        m_threads[THREAD_ROLE_CAPTURE] = capture_thread.native_handle();
+        decode_thread = std::thread(&camera_pipeline_c::decode_routine, this);
+        m_threads[THREAD_ROLE_DECODE] = decode_thread.native_handle();
+    }
+
+    display_routine();
+    stop();
+    decode_thread.join();
+    capture_thread.join();
+
+    return m_ret;
+}
+
+void camera_pipeline_c::stop(void)
+{
+    m_stopping = true;
+    m_captured.close();
+    m_decoded.close();
+}
 
-    while (true)
+// Reopens the source until it succeeds, with growing intervals between attempts. Returns false if stopped,
+// or if the source can't be reopened at all.
+bool camera_pipeline_c::reopen_source(float fps)
+{
+    int interval_ms = REOPEN_INTERVAL_MIN_MS;
+
+    for (int attempt = 1; !m_stopping; ++attempt)
     {
-        if (sig_check_critical_flag())
+        int ret = m_source.reopen();
+
+        if (-ENOTSUP == ret)
+            return false;
+
+        if (ret >= 0)
         {
-            fprintf(stderr, "Interrupted by user\n");
-            break;
+            if (fps > 0)
+                m_source.set_fps(fps);
+            ++m_reopen_count;
+            log_notice("Source reopened at attempt #%d", attempt);
+
+            return true;
+        }
+
+        log_warning("Failed to reopen source at attempt #%d, retrying in %dms", attempt, interval_ms);
+        for (int slept_ms = 0; slept_ms < interval_ms && !m_stopping; slept_ms += DISPLAY_POLL_MS)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(DISPLAY_POLL_MS));
+        }
+        interval_ms = std::min(interval_ms * 2, REOPEN_INTERVAL_MAX_MS);
+    }
+
+    return false;
+}
+
+void camera_pipeline_c::capture_routine(void)
+{
+    float applied_fps = 0; // by FPS changes, to be re-applied after reopening
+    std::chrono::steady_clock::time_point failure_time;
+    bool recovering = false;
+
+    apply_thread_policy(THREAD_ROLE_CAPTURE, m_policies[THREAD_ROLE_CAPTURE]);
+
+    while (!m_stopping)
+    {
+        // A new frame each time (from the pool if enabled), since the previous one may still be in use.
+        captured_frame_t captured;
+        float fps = m_pending_fps.exchange(0);
+        int replaced;
+
+        if (fps > 0)
+        {
+            m_source.set_fps(fps);
+            applied_fps = fps;
+            log_info("Capture FPS changed to %.1f", fps);
         }
 
-        if (!vicap.read(frame) || frame.empty())
+        if (!capture_frame(m_source, m_recorder, captured))
         {
-            fprintf(stderr, "*** Failed to capture frame!\n");
+            if (m_stopping)
+                break;
+
+            report_capture_failure(m_source);
+            if (m_args.watchdog <= 0 || m_source.exhausted())
+                break;
+
+            if (!recovering)
+            {
+                failure_time = std::chrono::steady_clock::now();
+                recovering = true;
+                m_last_frame_ms = 0;
+            }
+            if (!reopen_source(applied_fps))
+                break;
+
+            continue;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+
+        m_last_frame_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+        if (recovering)
+        {
+            m_last_recovery_ms = std::chrono::duration<double, std::milli>(now - failure_time).count();
+            recovering = false;
+            fprintf(stderr, "Capture recovered in %.0fms\n", m_last_recovery_ms.load());
+        }
+
+        if ((replaced = m_captured.put(std::move(captured))) < 0)
             break;
+        m_dropped_count += replaced;
+    }
+
+    // Decode thread takes the frame left in slot, then quits.
+    m_captured.close();
+}
+
+void camera_pipeline_c::dump_thread_usage(FILE *stream)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - m_last_usage_time).count();
+
+    // Workers of OpenCV and racers of decoders are not counted in decode thread.
+    fprintf(stream, "cpu:");
+    for (int i = 0; i < THREAD_ROLE_COUNT; ++i)
+    {
+        double seconds = thread_cpu_seconds(m_threads[i]);
+
+        if (seconds < 0)
+        {
+            fprintf(stream, " %s=-", thread_role_name(i));
+            continue;
+        }
+
+        fprintf(stream, " %s=%.1f%%", thread_role_name(i), (seconds - m_last_cpu_seconds[i]) * 100 / elapsed);
+        m_last_cpu_seconds[i] = seconds;
+    }
+    fprintf(stream, "\n");
+    m_last_usage_time = now;
+}
+
+void camera_pipeline_c::decode_routine(void)
+{
+    decoder_c decoder;
+    captured_frame_t captured;
+    cv::Mat &frame = captured.frame;
+    cv::Mat decode_frame;
+    cv::Mat luma;
+    std::set<std::string> barcode_items;
+    frame_governor_c governor(m_args.latency_budget, m_args.fps);
+    frame_preprocessor_c preprocessor(m_args.preprocess, m_args.roi_assist);
+    barcode_localizer_c localizer(m_args.localize);
+    quad_rescanner_c rescanner(m_args.rescan);
+    // Only frames of live sources are superseded, others queue up and are all decoded.
+    decode_deadline_c deadline(m_args.frame_deadline, [this] { return m_source.live() && m_captured.pending(); });
+    temporal_consensus_c consensus(m_args.consensus);
+    latency_histogram_c window_latency; // since the last statistics
+    latency_histogram_c total_latency;
+    tuning_params_t tuning = make_tuning_params(m_args, m_conf, max_frame_rate(m_args));
+    ZXing::DecodeHints hints;
+    uint64_t decoded_count = 0;
+    uint64_t skipped_count = 0;
+    uint64_t last_dropped_count = 0; // as of the previous frame fed to governor
+    time_t last_stats_time = time(nullptr);
+    int ret;
+
+    apply_thread_policy(THREAD_ROLE_DECODE, m_policies[THREAD_ROLE_DECODE]);
+
+    // Racers of decoder and workers of OpenCV are created from here on, and inherit the policy of this thread.
+    if ((ret = decoder.init(m_args.decoders, m_args.decode_mode)) < 0)
+    {
+        m_ret = ret;
+        stop();
+        return;
+    }
+
+    apply_tuning_params(tuning, nullptr, m_source_fps, governor, hints);
+    // Misreads of cheaper decoding are voted out by consensus, so that trying harder on every frame is unnecessary.
+    if (consensus.enabled())
+        hints.setTryHarder(false);
+
+    if (preprocessor.enabled())
+        fprintf(stderr, "Preprocessing: %s%s (SIMD: %s)\n", m_args.preprocess.c_str(),
+            m_args.roi_assist ? " + ROI assist" : "", frame_preprocessor_c::simd_name());
+
+    while (!m_stopping && m_captured.take(captured))
+    {
+        if (conf_file_reload_if_changed(m_conf))
+        {
+            tuning_params_t new_tuning = make_tuning_params(m_args, m_conf, max_frame_rate(m_args));
+
+            apply_tuning_params(new_tuning, &tuning, m_source_fps, governor, hints);
+            if (barcode_items.size() > (size_t)new_tuning.dedup_window)
+                barcode_items.clear();
+            tuning = new_tuning;
         }
 
-        auto barcode_result = detect_barcode(frame);
-        const std::string &text = QString::fromStdWString(barcode_result.text()).toStdString();
+        if (m_args.stats_interval > 0 && time(nullptr) - last_stats_time >= m_args.stats_interval)
+        {
+            fprintf(stderr, "stats: decoded=%llu rescanned=%llu skipped=%llu dropped=%llu unconfirmed=%llu"
+                " log_dropped=%llu\n", (unsigned long long)decoded_count, (unsigned long long)rescanner.hit_count(),
+                (unsigned long long)skipped_count,
+                (unsigned long long)m_dropped_count, (unsigned long long)consensus.rejected_count(),
+                (unsigned long long)logger_dropped_count());
+            if (m_args.watchdog > 0)
+                fprintf(stderr, "watchdog: reopened=%llu last_recovery=%.0fms\n",
+                    (unsigned long long)m_reopen_count, m_last_recovery_ms.load());
+            dump_thread_usage(stderr);
+            if (nullptr != m_pool)
+                m_pool->dump(stderr);
+            if (governor.enabled())
+                governor.dump(stderr);
+            if (deadline.enabled())
+                deadline.dump(stderr);
+            if (decoder.race_mode())
+                fprintf(stderr, "race: busy_skipped=%llu\n", (unsigned long long)decoder.busy_skip_count());
+            if (m_args.latency)
+                window_latency.dump(stderr, "latency");
+            window_latency.reset();
+            last_stats_time = time(nullptr);
+        }
 
-        if (ZXing::DecodeStatus::NoError == barcode_result.status()
-            && barcode_items.end() == barcode_items.find(text))
+        if (governor.should_skip())
+        {
+            ++skipped_count;
+            continue;
+        }
+
+        double age_ms = (steady_clock_ns() - captured.timestamp_ns) / 1e6; // waited in driver and slot
+        auto decode_begin = std::chrono::steady_clock::now();
+        float scale = governor.scale();
+
+        deadline.start_frame();
+        // The label found in the previous frame is most likely still around, rectified and at full resolution.
+        auto barcode_result = rescanner.rescan(frame, hints);
+        bool rescanned = barcode_info_ok(barcode_result);
+
+        if (!rescanned)
+        {
+            cv::Rect static_roi = clip_static_roi(tuning.roi, frame);
+            cv::Mat roi_frame = frame(static_roi);
+
+            if (scale < 1.0f)
+                cv::resize(roi_frame, decode_frame, cv::Size(), scale, scale, cv::INTER_AREA);
+            else
+                decode_frame = roi_frame;
+
+            barcode_result = detect_barcode(decode_frame, scale, decoder, deadline, hints, preprocessor, localizer, luma);
+            map_barcode_position(barcode_result, static_roi.tl(), 1.0f);
+
+            // A partial detection (located but not decoded) is given a rectified try at once.
+            if (rescanner.feed(barcode_result) && !barcode_info_ok(barcode_result))
+            {
+                auto rectified_result = rescanner.rescan(frame, hints);
+
+                if ((rescanned = barcode_info_ok(rectified_result)))
+                    barcode_result = rectified_result;
+            }
+        }
+        deadline.finish_frame();
+        double decode_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()
+            - decode_begin).count();
+        float fps = governor.fps();
+        uint64_t dropped_count = m_dropped_count;
+
+        // Frames superseded in the handoff slot while this one was decoded show that capture outpaces decoding.
+        governor.feed(decode_ms, age_ms, (int)(dropped_count - last_dropped_count));
+        last_dropped_count = dropped_count;
+        if (governor.take_fps_change(fps))
+            m_pending_fps = fps;
+        ++decoded_count;
+        log_debug("Frame #%llu: %s in %.1fms by %s, scale=%.2f, age=%.1fms", (unsigned long long)decoded_count,
+            ZXing::ToString(barcode_result.status), decode_ms,
+            rescanned ? "rescan" : (decoder.last_winner() ? decoder.last_winner() : "none"), scale, age_ms);
+
+        std::string text;
+
+        if (consensus.feed(barcode_result, text) && barcode_items.end() == barcode_items.find(text))
         {
             printf("%s\n", text.c_str());
-            barcode_items.insert(std::move(text));
-            if (barcode_items.size() > 10000/* FIXME: Specified through command-line. */)
+            if (m_args.latency)
+            {
+                double latency_ms = (steady_clock_ns() - captured.timestamp_ns) / 1e6;
+
+                window_latency.record(latency_ms);
+                total_latency.record(latency_ms);
+                fprintf(stderr, "Latency of %s: %.1fms\n", text.c_str(), latency_ms);
+            }
+            barcode_items.insert(text);
+            if (barcode_items.size() > (size_t)tuning.dedup_window)
                 barcode_items.clear();
         }
 
-        if (!display_func(WINDOW_NAME, barcode_result, frame))
-            break;
+        if (m_args.use_gui)
+            m_decoded.put(decoded_frame_t{ frame, barcode_result });
 
         // TODO: --oneshot, or --mode=oneshot|forever, or --max-detects=0|1|N
     }
 
-    vicap.release();
-    cv::destroyAllWindows();
+    if (m_args.latency)
+        total_latency.dump(stderr, "latency(total)");
+    stop();
+}
 
-    return EXIT_SUCCESS;
+void camera_pipeline_c::display_routine(void)
+{
+    const std::string &WINDOW_NAME = "Barcode Scanner (Press Esc to exit)";
+#ifdef HEADLESS
+    auto display_func = do_nothing_to_frame;
+#else
+    auto display_func = m_args.use_gui ? mark_and_display_frame : do_nothing_to_frame;
+#endif
+    decoded_frame_t decoded;
+    bool stall_reported = false;
+
+    apply_thread_policy(THREAD_ROLE_DISPLAY, m_policies[THREAD_ROLE_DISPLAY]);
+#ifndef HEADLESS
+    // No window without --gui, which would need a display server for nothing.
+    if (m_args.use_gui)
+        cv::namedWindow(WINDOW_NAME);
+#endif
+
+    while (!m_stopping)
+    {
+        if (sig_check_critical_flag())
+        {
+            fprintf(stderr, "Interrupted by user\n");
+            break;
+        }
+
+        if (m_decoded.take(decoded, DISPLAY_POLL_MS) && !display_func(WINDOW_NAME, decoded.info, decoded.frame))
+            break;
+
+        // Reading which blocks beyond the timeout can't be interrupted, but is reported at least once.
+        int64_t last_frame_ms = m_last_frame_ms;
+        int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+
+        if (m_args.watchdog > 0 && last_frame_ms > 0 && now_ms - last_frame_ms > m_args.watchdog && !stall_reported)
+        {
+            log_warning("No frame captured for %lldms", (long long)(now_ms - last_frame_ms));
+            stall_reported = true;
+        }
+        else if (now_ms - last_frame_ms <= m_args.watchdog)
+            stall_reported = false;
+    }
+
+#ifndef HEADLESS
+    if (m_args.use_gui)
+        cv::destroyAllWindows();
+#endif
+}
+
+/*
+ * Installed as the default allocator of matrices before any frame is captured, and never destroyed,
+ * since matrices allocated by it may be kept in caches of OpenCV till exit.
+ */
+static const frame_pool_c* install_frame_pool(int cap_mb)
+{
+    frame_pool_c *pool;
+
+    if (cap_mb <= 0)
+        return nullptr;
+
+    pool = new frame_pool_c((size_t)cap_mb << 20);
+    cv::Mat::setDefaultAllocator(pool);
+    fprintf(stderr, "Frame pool: up to %d MB\n", cap_mb);
+
+    return pool;
+}
+
+DECLARE_BIZ_FUN(detect_from_camera)
+{
+    std::unique_ptr<frame_source_c> source;
+    frame_recorder_c recorder;
+    thread_policies_t policies;
+    int ret = validate_several_args_again(parsed_args)
+        ? parse_thread_policies(parsed_args.thread_cpus, parsed_args.thread_sched, policies) : -EINVAL;
+
+    if (ret < 0)
+        return ret;
+
+    const frame_pool_c *pool = install_frame_pool(parsed_args.frame_pool);
+
+    if ((ret = open_source(parsed_args, source)) < 0)
+        return ret;
+
+    if (!parsed_args.record_file.empty() && (ret = recorder.open(parsed_args.record_file, parsed_args.fps)) < 0)
+    {
+        source->release();
+        return ret;
+    }
+
+    camera_pipeline_c pipeline(parsed_args, conf, *source, recorder, policies, pool);
+
+    fprintf(stderr, "Scanner started, press Ctrl+C whenever you want to stop\n");
+    ret = pipeline.run();
+
+    if (recorder.is_open())
+        fprintf(stderr, "%llu frames recorded into %s\n", (unsigned long long)recorder.frame_count(),
+            parsed_args.record_file.c_str());
+    recorder.close();
+    source->release();
+
+    return (ret < 0) ? ret : EXIT_SUCCESS;
 }
 
 /*
@@ -215,5 +881,31 @@ DECLARE_BIZ_FUN(detect_from_camera)
  *
  * >>> 2024-11-11, Man Hung-Coeng <udc577@126.com>:
  *  01. Change the window title to Barcode Scanner.
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Adjust FPS, decode resolution and skip ratio at runtime to hold a latency budget.
+ *  02. Print runtime statistics periodically.
+ *  03. Support contrast enhancement and ROI assist before detection.
+ *  04. Apply tuning parameters from command line and configuration file,
+ *      and re-apply them on the fly once configuration file is reloaded.
+ *  05. Log diagnostics of frame loop through the asynchronous logger.
+ *  06. Decode through pluggable decoder engines.
+ *  07. Support localizing barcode candidates before decoding.
+ *  08. Emit results only after consensus of several frames if --consensus is specified.
+ *  09. Read frames through frame sources, and support recording and replaying of them.
+ *  10. Run capture, decode and display on threads of their own, with optional CPU affinity
+ *      and scheduling policy, and print CPU usage of them in statistics.
+ *  11. Allocate frames from a pool if --frame-pool is specified.
+ *  12. Support reading frames from shared memory.
+ *  13. Support reading raw frames from stdin or a FIFO.
+ *  14. Rescan the quad of the last located barcode rectified with pure hints if --rescan is specified.
+ *  15. Decode frames in escalating stages within the deadline of --frame-deadline.
+ *  16. Never create any window without --gui, and support headless build.
+ *  17. Reopen the camera in place on failures or stalls if --watchdog is specified.
+ *  18. Measure latency from capture of frames to output if --latency is specified.
+ *  19. Draw marks of GUI on a copy of frame, instead of shared or reused buffers.
+ *  20. Feed the frame governor with measured age of frames and dropped frames.
+ *  21. Cap the frame rate of configuration file to the same limit as that of command line.
+ *  22. Record frames with their capture time.
  */
 
@@ -16,50 +16,558 @@
  * limitations under the License.
 */
 
+#include <string.h>
+#include <strings.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 #include <iostream>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
 
 #include <opencv2/core/mat.hpp>
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
+#ifndef HEADLESS
 #include <opencv2/highgui.hpp>
+#endif
 #include <ZXing/BarcodeFormat.h>
 #include <ZXing/DecodeHints.h>
-#include <ZXing/ReadBarcode.h>
-#include <ZXing/Result.h>
 #include <ZXing/DecodeStatus.h>
-#include <QtCore/QString>
+#ifndef HEADLESS
 #include <QtGui/QScreen>
 #include <QtGui/QGuiApplication>
+#endif
 
 #include "cmdline_args.hpp"
 #include "biz_common.hpp"
+#include "image_list.hpp"
+#include "barcode_info.hpp"
+#include "result_cache.hpp"
+#include "decoder_engine.hpp"
+#include "barcode_localizer.hpp"
+#include "shard_results.hpp"
+#include "archive_reader.hpp"
+
+#define BATCH_ITEMS_PER_WORKER          2 // one being decoded, and one read ahead
+
+static bool is_jpeg_file(const std::string &path)
+{
+    const char *dot = strrchr(path.c_str(), '.');
+
+    return nullptr != dot && (0 == strcasecmp(dot, ".jpg") || 0 == strcasecmp(dot, ".jpeg")
+        || 0 == strcasecmp(dot, ".jpe"));
+}
+
+// Pages of TIFF files, which are the only multi-page format of image codecs, or 1 for anything else.
+static int count_pages(const std::string &path)
+{
+    const char *dot = strrchr(path.c_str(), '.');
+
+    if (nullptr == dot || (0 != strcasecmp(dot, ".tif") && 0 != strcasecmp(dot, ".tiff")))
+        return 1;
+
+    return (int)cv::imcount(path);
+}
+
+static int reduced_imread_flag(int reduce_factor)
+{
+    switch (reduce_factor)
+    {
+    case 2:
+        return cv::IMREAD_REDUCED_GRAYSCALE_2;
+
+    case 4:
+        return cv::IMREAD_REDUCED_GRAYSCALE_4;
+
+    case 8:
+        return cv::IMREAD_REDUCED_GRAYSCALE_8;
+
+    default:
+        return cv::IMREAD_GRAYSCALE;
+    }
+}
+
+// Localized candidates are decoded (or the whole image if none is found) if localization is enabled.
+static barcode_info_t detect_barcode(decoder_c &decoder, barcode_localizer_c &localizer,
+    const ZXing::DecodeHints &hints, const cv::Mat &image)
+{
+    return localizer.enabled() ? localizer.decode(image, hints, decoder) : decoder.decode(image, hints);
+}
+
+/*
+ * For JPEG files, the decoder is able to skip most of its work (IDCT and color conversion)
+ * when producing a reduced grayscale image, which is usually good enough for barcodes.
+ * The full-scale image is decoded only if nothing is detected in the reduced one.
+ * The image is loaded from the encoded bytes if they're given, otherwise from the file,
+ * and returns false if it fails to be loaded. The position of info is always relative to the full-scale image.
+ */
+static bool detect_barcode_from_file(decoder_c &decoder, barcode_localizer_c &localizer,
+    const ZXing::DecodeHints &hints, const std::string &path, const cv::Mat &encoded, int reduce_factor, cv::Mat &image, int &pos_scale, barcode_info_t &info)
+{
+    auto load_image = [&path, &encoded](int flags) {
+        return encoded.empty() ? cv::imread(path, flags) : cv::imdecode(encoded, flags);
+    };
+
+    if (reduce_factor > 1 && is_jpeg_file(path))
+    {
+        image = load_image(reduced_imread_flag(reduce_factor));
+        if (!image.empty())
+        {
+            info = detect_barcode(decoder, localizer, hints, image);
+            if (barcode_info_ok(info))
+            {
+                pos_scale = reduce_factor;
+                map_barcode_position(info, cv::Point(0, 0), pos_scale);
+                return true;
+            }
+        }
+    }
+
+    pos_scale = 1;
+    image = load_image(cv::IMREAD_COLOR);
+    if (image.cols <= 0 || image.rows <= 0)
+        return false;
+
+    info = detect_barcode(decoder, localizer, hints, image);
+
+    return true;
+}
+
+/*
+ * With a cache, the file is memory-mapped so that its contents are read only once for both hashing and decoding,
+ * and the image is left empty on cache hit.
+ */
+static bool detect_barcode_from_file(decoder_c &decoder, barcode_localizer_c &localizer,
+    const ZXing::DecodeHints &hints, const std::string &path, const cmd_args_t &args, result_cache_c &cache, cv::Mat &image, int &pos_scale, barcode_info_t &info)
+{
+    int fd;
+    struct stat st;
+    void *addr;
+    bool loaded;
+
+    pos_scale = 1;
+
+    if (!cache.is_open())
+        return detect_barcode_from_file(decoder, localizer, hints, path, cv::Mat(), args.jpeg_reduce, image, pos_scale, info);
+
+    if ((fd = open(path.c_str(), O_RDONLY | O_CLOEXEC)) < 0)
+        return false;
+
+    if (fstat(fd, &st) < 0 || st.st_size <= 0
+        || MAP_FAILED == (addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0)))
+    {
+        close(fd);
+        return false;
+    }
+    close(fd);
+
+    uint64_t key = cache.make_key(addr, st.st_size);
+
+    if (cache.lookup(key, st.st_size, info))
+        loaded = true;
+    else if ((loaded = detect_barcode_from_file(decoder, localizer, hints, path, cv::Mat(1, st.st_size, CV_8UC1, addr),
+        args.jpeg_reduce, image, pos_scale, info)) && barcode_info_ok(info))
+        cache.insert(key, st.st_size, info);
+    else
+    {
+        // Failures are not cached, since they may succeed with other options or a newer decoder,
+        // and neither are broken files in case they're being written.
+    }
+
+    munmap(addr, st.st_size);
+
+    return loaded;
+}
+
+// Prints the result of an image, and writes it into the result file if any. Returns true if anything is detected.
+static bool report_result(const std::string &name, bool loaded, const barcode_info_t &result, bool is_batch,
+    shard_results_writer_c &results)
+{
+    const char *indent = is_batch ? "  " : "";
+
+    if (!loaded)
+    {
+        fprintf(stderr, "\n*** Image file does not exist, or failed to parse it: %s\n", name.c_str());
+        results.write(name, nullptr);
+        return false;
+    }
+
+    results.write(name, &result);
+    if (!barcode_info_ok(result))
+    {
+        fprintf(stderr, "\n%s: *** Failed to detect: %s\n", name.c_str(), ZXing::ToString(result.status));
+        return false;
+    }
+
+    if (is_batch)
+        printf("\n%s:\n", name.c_str());
+
+    std::cout << indent << "Type: " << ZXing::ToString(result.format) << std::endl
+        << indent <<"Text: " << result.text << std::endl
+        << indent <<"Orientation: " << result.orientation << std::endl
+        << indent <<"Error Correction Level: " << result.ec_level << std::endl
+        << indent <<"Bits: " << result.bits << std::endl;
+
+    return true;
+}
+
+/*
+ * Members of an archive, or pages of a multi-page document, are decoded by worker threads,
+ * each with decoders of its own, while the calling thread keeps feeding them:
+ *   1) members are read by the calling thread into a ring of reusable buffers, and decoded from memory,
+ *      so that reading overlaps with decoding and nothing is extracted;
+ *   2) pages are loaded by workers themselves, one page each at a time, so that a document is never
+ *      loaded as a whole however many pages it has.
+ * Results are reported by the calling thread in order, keyed as "ARCHIVE:MEMBER" or "DOCUMENT#PAGE",
+ * so that output is the same however many workers there are. Feeding waits while the ring is full.
+ */
+class batch_scanner_c
+{
+public:
+    batch_scanner_c(const cmd_args_t &args, const ZXing::DecodeHints &hints, shard_results_writer_c &results);
+
+    ~batch_scanner_c();
+
+public:
+    // Starts workers. Returns 0 or a negative error code.
+    int init(void);
+
+    // Returns 0, or a negative error code if the archive fails to be opened or read,
+    // in which case members read before are still reported.
+    int scan_archive(const std::string &path, uint64_t &total, uint64_t &successes);
+
+    // Page numbers in results start from 1.
+    void scan_pages(const std::string &path, int page_count, uint64_t &total, uint64_t &successes);
+
+private:
+    enum item_state_e
+    {
+        ITEM_FREE,
+        ITEM_FILLED,
+        ITEM_DONE,
+    };
+
+    typedef struct item
+    {
+        item_state_e state;
+        std::string name; // of member, or path of document
+        std::vector<uint8_t> data; // contents of member, with capacity kept across members
+        int page; // 0-based page of document, or -1 for member
+        bool loaded;
+        barcode_info_t info;
+    } item_t;
+
+    typedef struct worker
+    {
+        decoder_c decoder;
+        std::unique_ptr<barcode_localizer_c> localizer;
+        cv::Mat image;
+        std::vector<cv::Mat> pages;
+        std::thread thread;
+    } worker_t;
+
+    void work(worker_t &worker);
+
+    // Filler fills an item, and returns 1 if filled, 0 if nothing is left, or a negative error code.
+    // Key makes the name of an item in results.
+    int run(const std::function<int(item_t &)> &filler, const std::function<std::string(const item_t &)> &key,
+        uint64_t &total, uint64_t &successes);
+
+private:
+    const cmd_args_t &m_args;
+    const ZXing::DecodeHints &m_hints;
+    shard_results_writer_c &m_results;
+    std::vector<item_t> m_ring;
+    std::vector<std::unique_ptr<worker_t>> m_workers;
+    std::mutex m_lock;
+    std::condition_variable m_job_cond;
+    std::condition_variable m_done_cond;
+    std::deque<size_t> m_jobs; // indexes into ring
+    bool m_stopping;
+};
+
+batch_scanner_c::batch_scanner_c(const cmd_args_t &args, const ZXing::DecodeHints &hints,
+    shard_results_writer_c &results)
+    : m_args(args)
+    , m_hints(hints)
+    , m_results(results)
+    , m_stopping(false)
+{
+}
+
+batch_scanner_c::~batch_scanner_c()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        m_stopping = true;
+    }
+    m_job_cond.notify_all();
+    for (auto &worker : m_workers)
+    {
+        if (worker->thread.joinable())
+            worker->thread.join();
+    }
+}
+
+int batch_scanner_c::init(void)
+{
+    int count = (m_args.detect_threads > 0) ? m_args.detect_threads
+        : std::max(1, (int)std::thread::hardware_concurrency());
+    int ret;
+
+    m_ring.resize(count * BATCH_ITEMS_PER_WORKER);
+    for (auto &item : m_ring)
+    {
+        item.state = ITEM_FREE;
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        std::unique_ptr<worker_t> worker(new worker_t);
+
+        if ((ret = worker->decoder.init(m_args.decoders, m_args.decode_mode)) < 0)
+            return ret;
+
+        worker->localizer.reset(new barcode_localizer_c(m_args.localize));
+        worker->thread = std::thread(&batch_scanner_c::work, this, std::ref(*worker));
+        m_workers.push_back(std::move(worker));
+    }
+
+    return 0;
+}
+
+void batch_scanner_c::work(worker_t &worker)
+{
+    while (true)
+    {
+        size_t index;
+
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+
+            m_job_cond.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping)
+                break;
+
+            index = m_jobs.front();
+            m_jobs.pop_front();
+        }
+
+        item_t &item = m_ring[index];
+        int pos_scale = 1;
+
+        if (item.page >= 0)
+        {
+            // Decoders skip earlier pages by their directories, without decoding them.
+            item.loaded = cv::imreadmulti(item.name, worker.pages, item.page, 1, cv::IMREAD_GRAYSCALE)
+                && !worker.pages.empty() && !worker.pages[0].empty();
+            if (item.loaded)
+                item.info = detect_barcode(worker.decoder, *worker.localizer, m_hints, worker.pages[0]);
+            worker.pages.clear();
+        }
+        else
+        {
+            item.loaded = !item.data.empty() && detect_barcode_from_file(worker.decoder, *worker.localizer, m_hints,
+                item.name, cv::Mat(1, (int)item.data.size(), CV_8UC1, item.data.data()), m_args.jpeg_reduce, worker.image,
+                pos_scale, item.info);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+
+            item.state = ITEM_DONE;
+        }
+        m_done_cond.notify_one();
+    }
+}
+
+int batch_scanner_c::run(const std::function<int(item_t &)> &filler,
+    const std::function<std::string(const item_t &)> &key, uint64_t &total, uint64_t &successes)
+{
+    uint64_t fill_seq = 0;
+    uint64_t report_seq = 0;
+    bool ended = false;
+    int ret = 0;
+
+    while (!ended || report_seq < fill_seq)
+    {
+        // Results are reported as soon as they're ready in order, and waited for if the ring is full or nothing is left.
+        while (report_seq < fill_seq)
+        {
+            item_t &item = m_ring[report_seq % m_ring.size()];
+            std::unique_lock<std::mutex> lock(m_lock);
+
+            if (ITEM_DONE != item.state && !ended && fill_seq - report_seq < m_ring.size())
+                break;
+
+            m_done_cond.wait(lock, [&item] { return ITEM_DONE == item.state; });
+            lock.unlock();
+
+            ++total;
+            if (report_result(key(item), item.loaded, item.info, /* is_batch = */true, m_results))
+                ++successes;
+            item.state = ITEM_FREE;
+            ++report_seq;
+        }
+
+        if (ended)
+            continue;
+
+        item_t &item = m_ring[fill_seq % m_ring.size()];
+
+        if ((ret = filler(item)) <= 0)
+        {
+            ended = true;
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+
+            item.state = ITEM_FILLED;
+            m_jobs.push_back(fill_seq % m_ring.size());
+        }
+        m_job_cond.notify_one();
+        ++fill_seq;
+    }
+
+    return (ret < 0) ? ret : 0;
+}
+
+int batch_scanner_c::scan_archive(const std::string &path, uint64_t &total, uint64_t &successes)
+{
+    archive_reader_c reader;
+    int ret;
+
+    if ((ret = reader.open(path)) < 0)
+        return ret;
+
+    return run([&reader](item_t &item) {
+        item.page = -1;
+
+        return reader.next(item.name, item.data);
+    }, [&path](const item_t &item) {
+        return path + ":" + item.name;
+    }, total, successes);
+}
+
+void batch_scanner_c::scan_pages(const std::string &path, int page_count, uint64_t &total, uint64_t &successes)
+{
+    int next_page = 0;
+
+    run([&path, page_count, &next_page](item_t &item) {
+        if (next_page >= page_count)
+            return 0;
+
+        item.name = path;
+        item.page = next_page++;
+
+        return 1;
+    }, [](const item_t &item) {
+        return item.name + "#" + std::to_string(item.page + 1);
+    }, total, successes);
+}
+
+static void print_summary(uint64_t total, uint64_t successes, const result_cache_c *cache, const char *indent)
+{
+    std::cout << "\n>>> [Summary] <<<\n"
+        << indent << "Total: " << total << std::endl
+        << indent << "OK: " << successes << std::endl
+        << indent << "Failed: " << total - successes << std::endl;
+    if (nullptr != cache && cache->is_open())
+    {
+        std::cout << indent << "Cache Hits: " << cache->hits() << std::endl
+            << indent << "Cache Misses: " << cache->misses() << std::endl;
+    }
+    std::cout << std::endl;
+}
 
 DECLARE_BIZ_FUN(detect_from_images)
 {
     int ret = -EXIT_FAILURE;
-    int total = parsed_args.img_files->size();
-    int successes = 0;
-    bool has_multi_files = (total > 1);
-    const char *indent = has_multi_files ? "  " : "";
+    uint64_t total = 0;
+    uint64_t successes = 0;
+    image_list_c img_list(*parsed_args.img_files, parsed_args.manifest);
+    bool has_multi_files = img_list.is_batch();
+    std::string img_file;
+    result_cache_c cache;
+    decoder_c decoder;
+    barcode_localizer_c localizer(parsed_args.localize);
+    ZXing::BarcodeFormats formats;
+    ZXing::DecodeHints hints; // shared by all workers, read only
+    shard_results_writer_c results;
+    std::unique_ptr<batch_scanner_c> batch_scanner; // created on the first archive or multi-page document
+
+    if (!img_list.is_valid())
+        return -EXIT_FAILURE; // already reported
+
+    if (!parse_barcode_formats(parsed_args.formats, formats))
+        return -EINVAL;
+
+    hints.setFormats(formats);
 
-    for (const std::string &img_file : *parsed_args.img_files)
+    if ((ret = decoder.init(parsed_args.decoders, parsed_args.decode_mode)) < 0)
+        return ret;
+
+    if (!parsed_args.cache_file.empty() && (ret = cache.open(parsed_args.cache_file,
+        cv::format("decoders=%s;decode_mode=%s;formats=%s;localize=%d;jpeg_reduce=%d", parsed_args.decoders.c_str(),
+            parsed_args.decode_mode.c_str(), parsed_args.formats.c_str(), parsed_args.localize,
+            parsed_args.jpeg_reduce))) < 0)
+        return ret;
+
+    if (!parsed_args.results_file.empty()
+        && (ret = results.open(parsed_args.results_file, parsed_args.shard_index, parsed_args.shard_count)) < 0)
+        return ret;
+
+    img_list.set_shard(parsed_args.shard_index, parsed_args.shard_count);
+
+    while (img_list.next(img_file))
     {
-        cv::Mat image = cv::imread(img_file, cv::IMREAD_COLOR);
+        bool is_archive = archive_reader_c::is_archive_path(img_file);
+        int page_count = is_archive ? 0 : count_pages(img_file);
 
-        if (image.cols <= 0 || image.rows <= 0)
+        if (is_archive || page_count > 1)
         {
-            fprintf(stderr, "\n*** Image file does not exist, or failed to parse it: %s\n", img_file.c_str());
-            ret = -EXIT_FAILURE;
+            uint64_t failures = total - successes;
+            int err = 0;
+
+            has_multi_files = true;
+            if (!batch_scanner)
+            {
+                batch_scanner.reset(new batch_scanner_c(parsed_args, hints, results));
+                if ((ret = batch_scanner->init()) < 0)
+                    return ret;
+            }
+
+            if (is_archive)
+                err = batch_scanner->scan_archive(img_file, total, successes);
+            else
+                batch_scanner->scan_pages(img_file, page_count, total, successes);
+
+            // Fails if the archive is broken, or if any member or page fails.
+            ret = (err < 0 || total - successes > failures) ? -EXIT_FAILURE : EXIT_SUCCESS;
             continue;
         }
 
-        auto img_view = ZXing::ImageView(image.data, image.cols, image.rows, ZXing::ImageFormat::BGR);
-        ZXing::DecodeHints hints;
-        const auto &result = ZXing::ReadBarcode(img_view, hints.setFormats(ZXing::BarcodeFormat::Any));
+        ++total;
+
+        cv::Mat image;
+        int pos_scale = 1;
+        barcode_info_t result;
+        bool loaded = detect_barcode_from_file(decoder, localizer, hints, img_file, parsed_args, cache, image, pos_scale,
+            result);
 
-        if (ZXing::DecodeStatus::NoError != result.status())
+        if (!report_result(img_file, loaded, result, has_multi_files, results))
         {
-            fprintf(stderr, "\n%s: *** Failed to detect: %s\n", img_file.c_str(), ZXing::ToString(result.status()));
             ret = -EXIT_FAILURE;
             continue;
         }
@@ -67,36 +575,29 @@ DECLARE_BIZ_FUN(detect_from_images)
         ++successes;
         ret = EXIT_SUCCESS;
 
-        if (has_multi_files)
-            printf("\n%s:\n", img_file.c_str());
-
-        std::cout << indent << "Type: " << ZXing::ToString(result.format()) << std::endl
-            << indent <<"Text: " << QString::fromStdWString(result.text()).toStdString() << std::endl
-            << indent <<"Orientation: " << result.orientation() << std::endl
-            << indent <<"Error Correction Level: " << QString::fromStdWString(result.ecLevel()).toStdString() << std::endl
-            << indent <<"Bits: " << result.numBits() << std::endl;
-
-        if (!parsed_args.use_gui || img_file != parsed_args.img_files->back())
+#ifndef HEADLESS
+        if (!parsed_args.use_gui || !img_list.empty())
             continue;
 
+        if (image.empty() || pos_scale > 1)
+            image = cv::imread(img_file, cv::IMREAD_COLOR);
+
         QGuiApplication app(argc, argv);
         const auto &screen_size = app.primaryScreen()->size(); // Will crash if using QGuiApplication::primaryScreen()
-        const auto &pos = result.position();
-        const auto &top_left = pos.topLeft();
-        const auto &bottom_right = pos.bottomRight();
-        auto center = ZXing::Position::Point(std::min(top_left.x, bottom_right.x) + abs(bottom_right.x - top_left.x) / 2,
+        const auto &pos = result.position;
+        const auto &top_left = pos[0];
+        const auto &bottom_right = pos[2];
+        auto center = cv::Point(std::min(top_left.x, bottom_right.x) + abs(bottom_right.x - top_left.x) / 2,
             std::min(top_left.y, bottom_right.y) + abs(bottom_right.y - top_left.y) / 2);
         const cv::Scalar color(0, 0, 255);
         const int thickness = 2;
 
 #if 0
-        cv::rectangle(image, cv::Point(top_left.x, top_left.y), cv::Point(bottom_right.x, bottom_right.y),
-            color, thickness, cv::LineTypes::LINE_AA);
+        cv::rectangle(image, top_left, bottom_right, color, thickness, cv::LineTypes::LINE_AA);
 #endif
-        for (const auto &p : { top_left, pos.topRight(), pos.bottomLeft(), bottom_right, center })
+        for (const auto &p : { top_left, pos[1], pos[3], bottom_right, center })
         {
-            cv::drawMarker(image, cv::Point(p.x, p.y), color, cv::MarkerTypes::MARKER_DIAMOND,
-                /* markerSize = */20, thickness);
+            cv::drawMarker(image, p, color, cv::MarkerTypes::MARKER_DIAMOND, /* markerSize = */20, thickness);
         }
         if (image.cols > screen_size.width() || image.rows > screen_size.height())
         {
@@ -107,18 +608,37 @@ DECLARE_BIZ_FUN(detect_from_images)
         cv::imshow("Barcode Scanner", image);
         cv::waitKey(0);
         cv::destroyAllWindows();
+#endif
     }
 
     if (has_multi_files)
+        print_summary(total, successes, &cache, "  ");
+
+    int err = results.close();
+
+    return (err < 0) ? err : ret;
+}
+
+/*
+ * Result files of all shards are merged into the same summary as a single process gives.
+ * Fails if any image fails, or if any result file is broken, missing or unfinished.
+ */
+DECLARE_BIZ_FUN(merge_image_results)
+{
+    shard_summary_t summary;
+    int ret = shard_results_merge(*parsed_args.img_files, summary);
+
+    for (const auto &failure : summary.failures)
     {
-        std::cout << "\n>>> [Summary] <<<\n"
-            << indent << "Total: " << total << std::endl
-            << indent << "OK: " << successes << std::endl
-            << indent << "Failed: " << total - successes << std::endl
-            << std::endl;
+        fprintf(stderr, "*** Failed: %s\n", failure.c_str());
     }
 
-    return ret;
+    print_summary(summary.total, summary.successes, nullptr, "  ");
+
+    if (ret < 0)
+        return ret;
+
+    return (summary.successes < summary.total) ? -EXIT_FAILURE : EXIT_SUCCESS;
 }
 
 /*
@@ -131,5 +651,19 @@ DECLARE_BIZ_FUN(detect_from_images)
  *
  * >>> 2024-05-20, Man Hung-Coeng <udc577@126.com>:
  *  01. Improve some error messages.
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Stream image paths from command line, manifest files and directories with read-ahead.
+ *  02. Decode JPEG files at reduced scale first if --jpeg-reduce is specified.
+ *  03. Look up and save results in a persistent cache if --cache-file is specified.
+ *  04. Decode through pluggable decoder engines.
+ *  05. Support localizing barcode candidates before decoding.
+ *  06. Support headless build.
+ *  07. Support sharding, writing results into a file, and merging result files of shards.
+ *  08. Decode members of tar and zip archives in memory on worker threads.
+ *  09. Decode pages of multi-page TIFF files on worker threads.
+ *  10. Cache only successful results, under keys seeded with a fingerprint of detection options.
+ *  11. Fail if the manifest file fails to be opened.
+ *  12. Honor --formats for images, archive members and pages.
  */
 
@@ -18,8 +18,13 @@
 
 #include "signal_handling.h"
 
+#include <time.h>
+
 #include <opencv2/core/mat.hpp>
+#ifndef HEADLESS
 #include <opencv2/highgui.hpp>
+#endif
+#include <opencv2/videoio.hpp>
 #include <opencv2/videoio/registry.hpp>
 
 #include "cmdline_args.hpp"
@@ -63,10 +68,16 @@ DECLARE_BIZ_FUN(test_camera)
     }
 
     cv::Mat frame;
+#ifdef HEADLESS
+    // Nowhere to show frames, so how fast they come is shown instead.
+    time_t last_time = time(nullptr);
+    int frame_count = 0;
+#else
     const std::string &WINDOW_NAME = "Camera Test (Press Esc to exit)";
     const int ESC_KEY_CODE = 27;
 
     cv::namedWindow(WINDOW_NAME);
+#endif
 
     while (true)
     {
@@ -82,16 +93,28 @@ DECLARE_BIZ_FUN(test_camera)
             break;
         }
 
+#ifdef HEADLESS
+        ++frame_count;
+        if (time(nullptr) - last_time >= 1)
+        {
+            printf("%dx%d, %d frames in %lds\n", frame.cols, frame.rows, frame_count, (long)(time(nullptr) - last_time));
+            last_time = time(nullptr);
+            frame_count = 0;
+        }
+#else
         cv::imshow(WINDOW_NAME, frame);
 
         // NOTE: The waitKey() is necessary for HighGUI to perform some housekeeping tasks.
         //       Without it, the image won't display and the window might lock up.
         if (cv::waitKey(1) == ESC_KEY_CODE)
             break;
+#endif
     }
 
     vicap.release();
+#ifndef HEADLESS
     cv::destroyAllWindows();
+#endif
 
     return EXIT_SUCCESS;
 }
@@ -107,5 +130,8 @@ DECLARE_BIZ_FUN(test_camera)
  * >>> 2024-05-18, Man Hung-Coeng <udc577@126.com>:
  *  01. Eliminate some runtime errors of V4L2.
  *  02. Check OS signal within biz loop.
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Print frame rate instead of showing frames in headless build.
  */
 
@@ -31,6 +31,8 @@
 
 #include "versions.hpp"
 #include "biz_common.hpp"
+#include "thread_policy.hpp"
+#include "shard_results.hpp"
 
 // Must be coincident with the copyright info at the beginning of this file.
 #ifndef COPYRIGHT_STRING
@@ -43,7 +45,7 @@
 #endif
 
 #ifndef USAGE_FORMAT
-#define USAGE_FORMAT                    "[OPTION...] [FILE...]"
+#define USAGE_FORMAT                    "[OPTION...] [FILE|DIRECTORY...]"
 #endif
 
 #define __CSTR(x)                       #x
@@ -53,7 +55,7 @@
 #define PRODUCT_VERSION                 CSTR(MAJOR_VER) "." CSTR(MINOR_VER) "." CSTR(PATCH_VER)
 #endif
 
-#define BIZ_TYPE_CANDIDATES             "normal,test"
+#define BIZ_TYPE_CANDIDATES             "normal,test,merge"
 #define BIZ_TYPE_DEFAULT                "normal"
 
 #ifdef HAS_CONFIG_FILE
@@ -64,10 +66,6 @@
 
 #ifdef HAS_LOGGER
 
-#ifndef DEFAULT_LOG_FILE
-#define DEFAULT_LOG_FILE                "unnamed.log"
-#endif
-
 #ifndef LOG_LEVEL_CANDIDATES
 #define LOG_LEVEL_CANDIDATES            "debug,info,notice,warning,error,critical"
 #endif
@@ -78,7 +76,7 @@
 
 #endif // #ifdef HAS_LOGGER
 
-#define IMG_SOURCE_CANDIDATES           "camera,pic,video"
+#define IMG_SOURCE_CANDIDATES           "camera,pic,video,replay,shm,stdin"
 #define IMG_SOURCE_DEFAULT              "camera"
 
 #define DEVICE_ID_AUTO                  -1
@@ -97,7 +95,37 @@
 #define CAP_FPS_MAX                     120.0
 #define CAP_FPS_DEFAULT                 15.0
 
-#define CAP_FORMAT_CANDIDATES           "auto,nv12,grey"
+#define LATENCY_BUDGET_MAX              10000.0
+
+#define FRAME_DEADLINE_MAX              10000.0
+
+#define WATCHDOG_MAX                    60000 // in ms
+
+#define STATS_INTERVAL_MAX              3600
+
+#define JPEG_REDUCE_CANDIDATES          "1,2,4,8"
+#define JPEG_REDUCE_MAX                 8
+
+#define PREPROC_MODE_CANDIDATES         "none,stretch,clahe"
+#define PREPROC_MODE_DEFAULT            "none"
+
+#define DECODERS_DEFAULT                "zxing"
+
+#define LOCALIZE_MAX                    64
+
+#define CONSENSUS_MAX                   16
+
+#define REPLAY_SPEED_MAX                100
+
+#define FRAME_POOL_MAX                  4096 // in MB
+
+#define DECODE_MODE_CANDIDATES          "cascade,race"
+#define DECODE_MODE_DEFAULT             "cascade"
+
+#define DEDUP_WINDOW_MAX                10000000
+#define DEDUP_WINDOW_DEFAULT            10000
+
+#define CAP_FORMAT_CANDIDATES           "auto,nv12,grey,bgr"
 #define CAP_FORMAT_DEFAULT              "auto"
 
 #ifndef MAX_DETECT_THREADS
@@ -134,7 +162,8 @@ cmd_args_t parse_cmdline(int argc, char **argv)
 #ifdef HAS_LOGGER
         {
             { "logfile", required_argument, nullptr, 0 },
-            " /PATH/TO/LOG/FILE\n\t\t\tSpecify log file. Default to " DEFAULT_LOG_FILE "."
+            " /PATH/TO/LOG/FILE\n\t\t\tSpecify log file, written by a background thread."
+                "\n\t\t\tDefault to none (synchronously to stderr)."
         },
         {
             { "loglevel", required_argument, nullptr, 0 },
@@ -168,6 +197,32 @@ cmd_args_t parse_cmdline(int argc, char **argv)
             { "source", required_argument, nullptr, 's' },
             " {" IMG_SOURCE_CANDIDATES "}\n\t\t\tSpecify barcode source. Default to " IMG_SOURCE_DEFAULT "."
         },
+        {
+            { "manifest", required_argument, nullptr, 'm' },
+            " /PATH/TO/MANIFEST\n\t\t\tRead image paths (one per line) from the manifest file"
+            "\n\t\t\tin addition to FILE and DIRECTORY arguments, or from stdin if it's -."
+        },
+        {
+            { "jpeg-reduce", required_argument, nullptr, 0 },
+            " {" JPEG_REDUCE_CANDIDATES "}\n\t\t\tDecode JPEG files at 1/N scale in grayscale first,"
+            "\n\t\t\tand at full scale only if nothing is detected. Default to 1 (always full scale)."
+        },
+        {
+            { "cache-file", required_argument, nullptr, 0 },
+            " /PATH/TO/CACHE/FILE\n\t\t\tLook up and save results of image files by content hash"
+            "\n\t\t\tin the persistent cache file. Default to none (no cache)."
+        },
+        {
+            { "shard", required_argument, nullptr, 0 },
+            " I/N\n\t\t\tDetect only images of shard I (0-based) out of N, picked by hash of paths,"
+            "\n\t\t\tso that N processes given the same arguments share a batch out."
+            "\n\t\t\tDefault to 0/1 (all images)."
+        },
+        {
+            { "results", required_argument, nullptr, 0 },
+            " /PATH/TO/RESULT/FILE\n\t\t\tWrite results of images into the file as JSON lines,"
+            "\n\t\t\twhich are summed up by: -b merge -s pic FILE..."
+        },
         {
             { "device-id", required_argument, nullptr, 'i' },
             " {" CSTR(DEVICE_ID_AUTO) ",0,1,2,...}\n\t\t\tSpecify device ID."
@@ -197,18 +252,113 @@ cmd_args_t parse_cmdline(int argc, char **argv)
             " FPS\n\t\t\tSet frames-per-second to FPS ranging from " CSTR(CAP_FPS_MIN) " to " CSTR(CAP_FPS_MAX)
             ".\n\t\t\tDefault to " CSTR(CAP_FPS_DEFAULT) "."
         },
+        {
+            { "latency-budget", required_argument, nullptr, 0 },
+            " MS\n\t\t\tHold frame latency within MS milliseconds by adjusting FPS,"
+            "\n\t\t\tdecode resolution and skip ratio at runtime."
+            "\n\t\t\tDefault to 0 (disabled, frames are decoded as captured)."
+        },
+        {
+            { "frame-deadline", required_argument, nullptr, 0 },
+            " MS\n\t\t\tDecode each frame from cheap to expensive settings within MS milliseconds,"
+            "\n\t\t\tand give it up once out of time or superseded by a newer frame."
+            "\n\t\t\tDefault to 0 (disabled, frames are decoded with full settings at once)."
+        },
+        {
+            { "watchdog", required_argument, nullptr, 0 },
+            " MS\n\t\t\tReopen the camera in place once reading fails, or stalls for MS milliseconds"
+            "\n\t\t\t(with OpenCV 4.6+), instead of exiting.\n\t\t\tDefault to 0 (disabled)."
+        },
+        {
+            { "latency", no_argument, nullptr, 0 },
+            "\tReport latency of each barcode from capture of its frame to output,"
+            "\n\t\t\tand a histogram of them in statistics and on exit."
+        },
+        {
+            { "preprocess", required_argument, nullptr, 0 },
+            " {" PREPROC_MODE_CANDIDATES "}\n\t\t\tEnhance contrast of frames before detection."
+            " Default to " PREPROC_MODE_DEFAULT "."
+        },
+        {
+            { "roi-assist", no_argument, nullptr, 0 },
+            "\tDetect the region with strong gradients first, then the whole frame."
+        },
         {
             { "format", required_argument, nullptr, 0 },
-            " {" CAP_FORMAT_CANDIDATES "}\n\t\t\tSpecify frame format. Default to " CAP_FORMAT_DEFAULT "."
+            " {" CAP_FORMAT_CANDIDATES "}\n\t\t\tSpecify frame format, which is also the format of raw frames"
+            "\n\t\t\tread by -s stdin, together with --width and --height. Default to " CAP_FORMAT_DEFAULT "."
+        },
+        {
+            { "decoders", required_argument, nullptr, 0 },
+            " ENGINE[,ENGINE...]\n\t\t\tSpecify decoder engines in order of trial, such as zxing,opencv-qr."
+            "\n\t\t\tDefault to " DECODERS_DEFAULT "."
+        },
+        {
+            { "decode-mode", required_argument, nullptr, 0 },
+            " {" DECODE_MODE_CANDIDATES "}\n\t\t\tTry engines one by one, or run them in parallel"
+            " and take the first result.\n\t\t\tDefault to " DECODE_MODE_DEFAULT "."
+        },
+        {
+            { "localize", required_argument, nullptr, 0 },
+            " COUNT\n\t\t\tLocate at most COUNT barcode candidates first, and decode only them."
+            "\n\t\t\tDefault to 0, which means disabled."
+        },
+        {
+            { "rescan", no_argument, nullptr, 0 },
+            "\tRectify the region of the barcode last located, even if not decoded,"
+            "\n\t\t\tand rescan it with pure hints before the whole frame."
+        },
+        {
+            { "consensus", required_argument, nullptr, 0 },
+            " VOTES\n\t\t\tEmit a barcode only after it's read VOTES times in consecutive frames,"
+            "\n\t\t\tor merged from as many partial reads.\n\t\t\tDefault to 1, which means disabled."
+        },
+        {
+            { "record", required_argument, nullptr, 0 },
+            " /PATH/TO/RECORDING/FILE\n\t\t\tRecord captured frames into file, which can be replayed by -s replay."
+        },
+        {
+            { "replay-speed", required_argument, nullptr, 0 },
+            " FACTOR\n\t\t\tSpecify replaying speed relative to the recording, 0 for as fast as possible."
+            "\n\t\t\tDefault to 1."
+        },
+        {
+            { "formats", required_argument, nullptr, 0 },
+            " FORMAT[,FORMAT...]\n\t\t\tSpecify barcode formats to detect, such as QRCode,EAN13."
+            "\n\t\t\tDefault to any."
+        },
+        {
+            { "dedup-window", required_argument, nullptr, 0 },
+            " COUNT\n\t\t\tSpecify how many distinct results are remembered for de-duplication."
+            "\n\t\t\tDefault to " CSTR(DEDUP_WINDOW_DEFAULT) "."
         },
         {
             { "detect-threads", required_argument, nullptr, 0 },
             " {0,1,2,...," CSTR(MAX_DETECT_THREADS) "}\n\t\t\tSpecify number of detect threads. Default to 0 (auto)."
         },
+        {
+            { "frame-pool", required_argument, nullptr, 0 },
+            " MB\n\t\t\tAllocate frame buffers from a pool holding at most MB megabytes,"
+            "\n\t\t\tand reuse them instead of going back to heap.\n\t\t\tDefault to 0 (disabled)."
+        },
+        {
+            { "cpus", required_argument, nullptr, 0 },
+            " ROLE=CPUS[/ROLE=CPUS...]\n\t\t\tPin threads of ROLE {" THREAD_ROLE_CANDIDATES "} to CPUS,"
+            "\n\t\t\tsuch as capture=0/decode=4-7. Default to none (decided by OS)."
+        },
+        {
+            { "sched", required_argument, nullptr, 0 },
+            " ROLE=POLICY[:PRIORITY][/...]\n\t\t\tSet scheduling POLICY {other,fifo,rr} of threads of ROLE,"
+            "\n\t\t\tsuch as decode=fifo:50. Default to none (other)."
+        },
         {
             { "backend", required_argument, nullptr, 'B' },
             "\n\t\t\tSpecify software backend. Default to " DEFAULT_BACKEND "."
         },
+        {
+            { "stats", required_argument, nullptr, 0 },
+            " SECONDS\n\t\t\tPrint runtime statistics every SECONDS seconds. Default to 0 (never)."
+        },
     };
     std::vector<struct option> long_options;
     std::map<std::string, char> abbr_map;
@@ -247,7 +397,6 @@ cmd_args_t parse_cmdline(int argc, char **argv)
     result.config_file = DEFAULT_CONF_FILE;
 #endif
 #ifdef HAS_LOGGER
-    result.log_file = DEFAULT_LOG_FILE;
     result.log_level = LOG_LEVEL_DEFAULT;
 #endif
     result.source = IMG_SOURCE_DEFAULT;
@@ -259,6 +408,16 @@ cmd_args_t parse_cmdline(int argc, char **argv)
     result.width = CAP_WIDTH_DEFAULT;
     result.height = CAP_HEIGHT_DEFAULT;
     result.detect_threads = 0;
+    result.latency_budget = 0;
+    result.stats_interval = 0;
+    result.jpeg_reduce = 1;
+    result.shard_count = 1;
+    result.preprocess = PREPROC_MODE_DEFAULT;
+    result.decoders = DECODERS_DEFAULT;
+    result.decode_mode = DECODE_MODE_DEFAULT;
+    result.dedup_window = DEDUP_WINDOW_DEFAULT;
+    result.consensus = 1;
+    result.replay_speed = 1.0f;
     result.backend = DEFAULT_BACKEND;
 
     while (true)
@@ -300,10 +459,64 @@ cmd_args_t parse_cmdline(int argc, char **argv)
 #endif
             else if (0 == strcmp(long_opt, "fps"))
                 result.fps = atof(optarg);
+            else if (0 == strcmp(long_opt, "latency-budget"))
+                result.latency_budget = atof(optarg);
+            else if (0 == strcmp(long_opt, "frame-deadline"))
+                result.frame_deadline = atof(optarg);
+            else if (0 == strcmp(long_opt, "watchdog"))
+                result.watchdog = atoi(optarg);
+            else if (0 == strcmp(long_opt, "stats"))
+                result.stats_interval = atoi(optarg);
+            else if (0 == strcmp(long_opt, "jpeg-reduce"))
+                result.jpeg_reduce = atoi(optarg);
+            else if (0 == strcmp(long_opt, "cache-file"))
+                result.cache_file = optarg;
+            else if (0 == strcmp(long_opt, "shard"))
+            {
+                char tail;
+
+                if (2 != sscanf(optarg, "%d/%d%c", &result.shard_index, &result.shard_count, &tail))
+                {
+                    fprintf(stderr, "*** Invalid shard: %s\nMust be like I/N\n", optarg);
+                    exit(EINVAL);
+                }
+            }
+            else if (0 == strcmp(long_opt, "results"))
+                result.results_file = optarg;
+            else if (0 == strcmp(long_opt, "preprocess"))
+                result.preprocess = optarg;
+            else if (0 == strcmp(long_opt, "roi-assist"))
+                result.roi_assist = true;
+            else if (0 == strcmp(long_opt, "decoders"))
+                result.decoders = optarg;
+            else if (0 == strcmp(long_opt, "decode-mode"))
+                result.decode_mode = optarg;
+            else if (0 == strcmp(long_opt, "localize"))
+                result.localize = atoi(optarg);
+            else if (0 == strcmp(long_opt, "rescan"))
+                result.rescan = true;
+            else if (0 == strcmp(long_opt, "latency"))
+                result.latency = true;
+            else if (0 == strcmp(long_opt, "consensus"))
+                result.consensus = atoi(optarg);
+            else if (0 == strcmp(long_opt, "record"))
+                result.record_file = optarg;
+            else if (0 == strcmp(long_opt, "replay-speed"))
+                result.replay_speed = atof(optarg);
+            else if (0 == strcmp(long_opt, "formats"))
+                result.formats = optarg;
+            else if (0 == strcmp(long_opt, "dedup-window"))
+                result.dedup_window = atoi(optarg);
             else if (0 == strcmp(long_opt, "format"))
                 result.format = optarg;
             else if (0 == strcmp(long_opt, "detect-threads"))
                 result.detect_threads = atoi(optarg);
+            else if (0 == strcmp(long_opt, "frame-pool"))
+                result.frame_pool = atoi(optarg);
+            else if (0 == strcmp(long_opt, "cpus"))
+                result.thread_cpus = optarg;
+            else if (0 == strcmp(long_opt, "sched"))
+                result.thread_sched = optarg;
             else if (0 == strcmp(long_opt, "device-prefix"))
                 result.dev_prefix = optarg;
             else
@@ -322,6 +535,8 @@ cmd_args_t parse_cmdline(int argc, char **argv)
             result.use_gui = true;
         else if (abbr_map["source"] == c)
             result.source = optarg;
+        else if (abbr_map["manifest"] == c)
+            result.manifest = optarg;
         else if (abbr_map["device-id"] == c)
             result.dev_id = atoi(optarg);
         else if (abbr_map["device-id-max"] == c)
@@ -402,7 +617,6 @@ void assert_parsed_args(const cmd_args_t &args)
         { "config file", args.config_file.c_str() },
 #endif
 #ifdef HAS_LOGGER
-        { "log file", args.log_file.c_str() },
         { "log level", args.log_level.c_str() },
         { "device prefix", args.dev_prefix.c_str() },
         { "backend", args.backend.c_str() },
@@ -420,6 +634,8 @@ void assert_parsed_args(const cmd_args_t &args)
 #endif
         { "image source", args.source.c_str(), IMG_SOURCE_CANDIDATES },
         { "frame format", args.format.c_str(), CAP_FORMAT_CANDIDATES },
+        { "preprocess mode", args.preprocess.c_str(), PREPROC_MODE_CANDIDATES },
+        { "decode mode", args.decode_mode.c_str(), DECODE_MODE_CANDIDATES },
         { "backend", args.backend.c_str(), get_camera_backends() },
     };
 
@@ -450,10 +666,40 @@ void assert_parsed_args(const cmd_args_t &args)
     assert_comparable_arg("frame height", args.height, CAP_HEIGHT_MIN, CAP_HEIGHT_MAX);
     assert_comparable_arg("frame FPS", args.fps, (float)CAP_FPS_MIN, (float)CAP_FPS_MAX);
     assert_comparable_arg("detect thread count", args.detect_threads, 0, MAX_DETECT_THREADS);
+    assert_comparable_arg("latency budget", args.latency_budget, 0.0f, (float)LATENCY_BUDGET_MAX);
+    assert_comparable_arg("frame deadline", args.frame_deadline, 0.0f, (float)FRAME_DEADLINE_MAX);
+    assert_comparable_arg("watchdog timeout", args.watchdog, 0, WATCHDOG_MAX);
+    assert_comparable_arg("stats interval", args.stats_interval, 0, STATS_INTERVAL_MAX);
+    assert_comparable_arg("JPEG reduce factor", args.jpeg_reduce, 1, JPEG_REDUCE_MAX);
+    assert_comparable_arg("de-duplication window", args.dedup_window, 1, DEDUP_WINDOW_MAX);
+    assert_comparable_arg("localization candidate count", args.localize, 0, LOCALIZE_MAX);
+    assert_comparable_arg("consensus votes", args.consensus, 1, CONSENSUS_MAX);
+    assert_comparable_arg("replay speed", args.replay_speed, 0.0f, (float)REPLAY_SPEED_MAX);
+    assert_comparable_arg("frame pool size", args.frame_pool, 0, FRAME_POOL_MAX);
+    assert_comparable_arg("shard count", args.shard_count, 1, SHARD_COUNT_MAX);
+    if (args.shard_index < 0 || args.shard_index >= args.shard_count)
+    {
+        fprintf(stderr, "*** Shard index %d is out of range[0, %d)!\n", args.shard_index, args.shard_count);
+        exit(EINVAL);
+    }
+    if (0 != (args.jpeg_reduce & (args.jpeg_reduce - 1)))
+    {
+        fprintf(stderr, "*** Invalid JPEG reduce factor: %d\nMust be one of {%s}\n",
+            args.jpeg_reduce, JPEG_REDUCE_CANDIDATES);
+        exit(EINVAL);
+    }
 
-    if ("camera" != args.source && args.img_files->empty())
+#ifdef HEADLESS
+    if (args.use_gui)
     {
-        fprintf(stderr, "*** Image or video file(s) not specified!\n");
+        fprintf(stderr, "*** GUI is not supported by headless build!\n");
+        exit(EINVAL);
+    }
+#endif
+
+    if ("camera" != args.source && "stdin" != args.source && args.img_files->empty() && args.manifest.empty())
+    {
+        fprintf(stderr, "*** Image or video file(s), or name of shared memory not specified!\n");
         exit(EINVAL);
     }
 } // void assert_parsed_args(const cmd_args_t &args)
@@ -470,5 +716,28 @@ void assert_parsed_args(const cmd_args_t &args)
  *  01. Fix the bug of parsing --debug option.
  *  02. Rename option --camera-id* to --device-id*.
  *  03. Add option --device-prefix, --detect-threads and --backend.
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Add option --latency-budget and --stats.
+ *  02. Add option --manifest.
+ *  03. Add option --jpeg-reduce.
+ *  04. Add option --cache-file.
+ *  05. Add option --preprocess and --roi-assist.
+ *  06. Add option --formats and --dedup-window.
+ *  07. Add option --decoders and --decode-mode.
+ *  08. Add option --localize.
+ *  09. Add option --consensus.
+ *  10. Add option --record and --replay-speed, and source type replay.
+ *  11. Add option --cpus and --sched.
+ *  12. Add option --frame-pool.
+ *  13. Add source type shm.
+ *  14. Add source type stdin, and frame format bgr.
+ *  15. Add option --rescan.
+ *  16. Add option --frame-deadline.
+ *  17. Refuse --gui in headless build.
+ *  18. Add option --watchdog.
+ *  19. Add option --latency.
+ *  20. Add option --shard and --results, and biz type merge.
+ *  21. Log to stderr synchronously unless --logfile is specified.
  */
 
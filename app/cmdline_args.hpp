@@ -39,13 +39,38 @@ typedef struct cmd_args
     std::string backend;
     std::string dev_prefix;
     std::vector<std::string> *img_files;
+    std::string manifest;
+    std::string cache_file;
+    std::string results_file;
+    std::string preprocess;
+    std::string formats;
+    std::string decoders;
+    std::string decode_mode;
+    std::string record_file;
+    std::string thread_cpus;
+    std::string thread_sched;
     float fps;
+    float latency_budget;
+    float frame_deadline;
+    float replay_speed;
     int dev_id;
     int dev_id_max;
     int width;
     int height;
     int detect_threads;
+    int stats_interval;
+    int watchdog; // in ms
+    int jpeg_reduce;
+    int dedup_window;
+    int localize;
+    int consensus;
+    int frame_pool; // in MB
+    int shard_index;
+    int shard_count;
     bool use_gui;
+    bool roi_assist;
+    bool rescan;
+    bool latency;
 } cmd_args_t;
 
 cmd_args_t parse_cmdline(int argc, char **argv);
@@ -65,5 +90,24 @@ void assert_parsed_args(const cmd_args_t &args);
  * >>> 2024-05-18, Man Hung-Coeng <udc577@126.com>:
  *  01. struct cmd_args: Rename camera_id* to dev_id*;
  *      add dev_prefix, detect_threads and backend.
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Add latency_budget and stats_interval.
+ *  02. Add manifest.
+ *  03. Add jpeg_reduce.
+ *  04. Add cache_file.
+ *  05. Add preprocess and roi_assist.
+ *  06. Add formats and dedup_window.
+ *  07. Add decoders and decode_mode.
+ *  08. Add localize.
+ *  09. Add consensus.
+ *  10. Add record_file and replay_speed.
+ *  11. Add thread_cpus and thread_sched.
+ *  12. Add frame_pool.
+ *  13. Add rescan.
+ *  14. Add frame_deadline.
+ *  15. Add watchdog.
+ *  16. Add latency.
+ *  17. Add results_file, shard_index and shard_count.
  */
 
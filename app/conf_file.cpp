@@ -0,0 +1,309 @@
+/*
+ * APIs for loading and hot-reloading the configuration file.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "conf_file.hpp"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/stat.h>
+
+#include "cmdline_args.hpp"
+
+#define MTIME_CHECK_INTERVAL            1 // in seconds
+
+#ifndef MAX_DETECT_THREADS
+#define MAX_DETECT_THREADS              64
+#endif
+
+#ifdef HAS_CONFIG_FILE
+
+static volatile sig_atomic_t s_reload_requested = 0;
+
+static void on_reload_signal(int signum)
+{
+    s_reload_requested = 1;
+}
+
+static std::string trim(const std::string &str)
+{
+    size_t begin = 0;
+    size_t end = str.size();
+
+    while (begin < end && isspace((unsigned char)str[begin]))
+    {
+        ++begin;
+    }
+
+    while (end > begin && isspace((unsigned char)str[end - 1]))
+    {
+        --end;
+    }
+
+    return str.substr(begin, end - begin);
+}
+
+static int parse_ini_file(const char *path, std::map<std::string, std::string> &items)
+{
+    FILE *fp = fopen(path, "r");
+    char *line = nullptr;
+    size_t cap = 0;
+    int line_no = 0;
+    std::string section;
+
+    if (nullptr == fp)
+        return -errno;
+
+    while (getline(&line, &cap, fp) >= 0)
+    {
+        std::string content = line;
+        size_t pos = content.find_first_of("#;");
+
+        ++line_no;
+        if (std::string::npos != pos)
+            content.erase(pos);
+        content = trim(content);
+
+        if (content.empty())
+            continue;
+
+        if ('[' == content.front() && ']' == content.back())
+        {
+            section = trim(content.substr(1, content.size() - 2));
+            continue;
+        }
+
+        if (std::string::npos == (pos = content.find('=')))
+        {
+            fprintf(stderr, "*** %s:%d: Invalid line, ignored: %s\n", path, line_no, content.c_str());
+            continue;
+        }
+
+        std::string key = trim(content.substr(0, pos));
+
+        for (auto &c : key)
+        {
+            c = tolower((unsigned char)c);
+        }
+        items[section.empty() ? key : (section + "." + key)] = trim(content.substr(pos + 1));
+    }
+
+    free(line);
+    fclose(fp);
+
+    return 0;
+}
+
+// Modification time alone is at 1 s resolution on some file systems, and misses a second edit within the same second.
+static bool stat_changed(const conf_file_t &conf)
+{
+    struct stat st;
+
+    if (0 != stat(conf.path.c_str(), &st))
+        memset(&st, 0, sizeof(st));
+
+    if (st.st_mtim.tv_sec == conf.mtime.tv_sec && st.st_mtim.tv_nsec == conf.mtime.tv_nsec
+        && st.st_size == conf.size && st.st_ino == conf.inode)
+        return false;
+
+    conf.mtime = st.st_mtim;
+    conf.size = st.st_size;
+    conf.inode = st.st_ino;
+
+    return true;
+}
+
+#endif // #ifdef HAS_CONFIG_FILE
+
+int conf_file_load(const char *path, conf_file_t &conf)
+{
+#ifdef HAS_CONFIG_FILE
+    std::map<std::string, std::string> items;
+    int err = parse_ini_file(path, items);
+
+    conf.path = path;
+    conf.mtime = {};
+    conf.size = 0;
+    conf.inode = 0;
+    stat_changed(conf);
+    conf.last_check_time = time(nullptr);
+
+    if (-ENOENT == err)
+    {
+        // Not an error, since the file will be picked up once it's created.
+        fprintf(stderr, "Configuration file %s does not exist, defaults are used\n", path);
+        return 0;
+    }
+
+    if (err < 0)
+    {
+        fprintf(stderr, "*** Failed to load configuration file %s: %s\n", path, strerror(-err));
+        return err;
+    }
+
+    std::lock_guard<std::mutex> guard(conf.lock);
+
+    conf.items.swap(items);
+#endif
+
+    return 0;
+}
+
+void conf_file_unload(conf_file_t &conf)
+{
+#ifdef HAS_CONFIG_FILE
+    std::lock_guard<std::mutex> guard(conf.lock);
+
+    conf.items.clear();
+#endif
+}
+
+int conf_file_watch_signal(void)
+{
+#ifdef HAS_CONFIG_FILE
+    struct sigaction act = {};
+
+    act.sa_handler = on_reload_signal;
+    sigemptyset(&act.sa_mask);
+    act.sa_flags = SA_RESTART;
+    if (sigaction(SIGHUP, &act, nullptr) < 0)
+        return -errno;
+#endif
+
+    return 0;
+}
+
+bool conf_file_reload_if_changed(const conf_file_t &conf)
+{
+#ifdef HAS_CONFIG_FILE
+    time_t now = time(nullptr);
+    bool signaled = (0 != s_reload_requested);
+
+    if (!signaled && now - conf.last_check_time < MTIME_CHECK_INTERVAL)
+        return false;
+
+    conf.last_check_time = now;
+    if (!stat_changed(conf) && !signaled)
+        return false;
+
+    s_reload_requested = 0;
+
+    std::map<std::string, std::string> items;
+    int err = parse_ini_file(conf.path.c_str(), items);
+
+    if (err < 0)
+    {
+        fprintf(stderr, "*** Failed to reload configuration file %s: %s\n", conf.path.c_str(), strerror(-err));
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(conf.lock);
+
+    conf.items.swap(items);
+    fprintf(stderr, "Configuration file %s reloaded\n", conf.path.c_str());
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool conf_file_get(const conf_file_t &conf, const char *key, std::string &value)
+{
+#ifdef HAS_CONFIG_FILE
+    std::lock_guard<std::mutex> guard(conf.lock);
+    const auto &iter = conf.items.find(key);
+
+    if (conf.items.end() == iter)
+        return false;
+
+    value = iter->second;
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Returns false and leaves the value untouched if the item is absent or invalid.
+template<typename T>
+static bool get_number(const conf_file_t &conf, const char *key, T min, T max, T &value)
+{
+    std::string str;
+    char *end = nullptr;
+
+    if (!conf_file_get(conf, key, str))
+        return false;
+
+    double num = strtod(str.c_str(), &end);
+
+    if (str.empty() || '\0' != *end || num < min || num > max)
+    {
+        fprintf(stderr, "*** Invalid value of %s in configuration file, ignored: %s\n", key, str.c_str());
+        return false;
+    }
+
+    value = (T)num;
+
+    return true;
+}
+
+tuning_params_t make_tuning_params(const struct cmd_args &args, const conf_file_t &conf, float max_fps)
+{
+    tuning_params_t params = {};
+    std::string str;
+
+    params.formats = args.formats;
+    params.detect_threads = args.detect_threads;
+    params.dedup_window = args.dedup_window;
+    params.fps = args.fps;
+
+    if (conf_file_get(conf, "detect.formats", str))
+        params.formats = str;
+    get_number(conf, "detect.threads", 0, MAX_DETECT_THREADS, params.detect_threads);
+    get_number(conf, "detect.dedup_window", 1, INT32_MAX, params.dedup_window);
+    get_number(conf, "capture.fps", 0.1f, max_fps, params.fps); // the same range as command line
+
+    if (conf_file_get(conf, "detect.roi", str))
+    {
+        int roi[4];
+
+        if (4 == sscanf(str.c_str(), "%d , %d , %d , %d", &roi[0], &roi[1], &roi[2], &roi[3])
+            && roi[0] >= 0 && roi[1] >= 0 && roi[2] >= 0 && roi[3] >= 0)
+            memcpy(params.roi, roi, sizeof(roi));
+        else
+            fprintf(stderr, "*** Invalid value of detect.roi in configuration file, ignored: %s\n", str.c_str());
+    }
+
+    return params;
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Detect changes by modification time in nanoseconds, size and inode,
+ *      and cap the frame rate to the limit of caller.
+ */
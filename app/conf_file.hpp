@@ -0,0 +1,94 @@
+/*
+ * APIs for loading and hot-reloading the configuration file.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __CONF_FILE_HPP__
+#define __CONF_FILE_HPP__
+
+#include <time.h>
+#include <sys/types.h>
+
+#include <string>
+#include <map>
+#include <mutex>
+
+struct cmd_args;
+
+/*
+ * The configuration file is in INI format:
+ *
+ *   # comment
+ *   [section]
+ *   key = value
+ *
+ * and items are addressed as "section.key". It's reloaded if SIGHUP is received
+ * or its modification time (in ns), size or inode changes, and users of tunable items are expected to
+ * call conf_file_reload_if_changed() in their loops to pick up changes.
+ */
+typedef struct conf_file
+{
+#ifdef HAS_CONFIG_FILE
+    std::string path;
+    mutable std::mutex lock;
+    mutable std::map<std::string, std::string> items;
+    mutable struct timespec mtime;
+    mutable off_t size;
+    mutable ino_t inode;
+    mutable time_t last_check_time;
+#endif
+} conf_file_t;
+
+int conf_file_load(const char *path, conf_file_t &conf);
+
+void conf_file_unload(conf_file_t &conf);
+
+// Reloads on SIGHUP, besides checking modification time of file.
+int conf_file_watch_signal(void);
+
+// Returns true if the file has been reloaded successfully.
+bool conf_file_reload_if_changed(const conf_file_t &conf);
+
+bool conf_file_get(const conf_file_t &conf, const char *key, std::string &value);
+
+/*
+ * Parameters that can be tuned at runtime without restarting the biz.
+ * Initial values come from command line, and are overridden by items of configuration file if present.
+ */
+typedef struct tuning_params
+{
+    std::string formats; // comma-separated barcode format names, or empty for any
+    int detect_threads;
+    int dedup_window;
+    int roi[4]; // x, y, width and height within frame, or zero width or height for the whole frame
+    float fps;
+} tuning_params_t;
+
+// The frame rate is capped to max_fps, the same limit as that applied to command line by the caller.
+tuning_params_t make_tuning_params(const struct cmd_args &args, const conf_file_t &conf, float max_fps);
+
+#endif /* #ifndef __CONF_FILE_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Detect changes by modification time in nanoseconds, size and inode,
+ *      and cap the frame rate to the limit of caller.
+ */
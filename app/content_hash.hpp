@@ -0,0 +1,37 @@
+/*
+ * Fast non-cryptographic hash of contents.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __CONTENT_HASH_HPP__
+#define __CONTENT_HASH_HPP__
+
+#include <stddef.h>
+#include <stdint.h>
+
+// XXH64 algorithm, see https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+uint64_t xxh64(const void *data, size_t len, uint64_t seed = 0);
+
+#endif /* #ifndef __CONTENT_HASH_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ */
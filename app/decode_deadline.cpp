@@ -0,0 +1,152 @@
+/*
+ * Decoding of a frame in escalating stages within a deadline.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "decode_deadline.hpp"
+
+#include <algorithm>
+
+#include "decoder_engine.hpp"
+
+#define EWMA_ALPHA                      0.2
+#define EWMA_SKIP_DECAY                 0.9 // an estimate 2x too high is probed again after 7 skips
+
+static const char* const STAGE_NAMES[DECODE_STAGE_COUNT] = { "fast", "harder", "full" };
+
+static inline double elapsed_ms(const std::chrono::steady_clock::time_point &since)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+}
+
+decode_deadline_c::decode_deadline_c(float deadline_ms, const std::function<bool(void)> &superseded)
+    : m_deadline_ms(deadline_ms)
+    , m_superseded(superseded)
+    , m_frame_begin(std::chrono::steady_clock::now())
+    , m_stages_run(0)
+    , m_given_up(false)
+    , m_frame_superseded(false)
+    , m_missed_count(0)
+    , m_superseded_count(0)
+{
+    std::fill(m_stage_ewma, m_stage_ewma + DECODE_STAGE_COUNT, -1.0);
+}
+
+void decode_deadline_c::start_frame(void)
+{
+    m_frame_begin = std::chrono::steady_clock::now();
+    m_stages_run = 0;
+    m_given_up = false;
+    m_frame_superseded = false;
+}
+
+void decode_deadline_c::finish_frame(void)
+{
+    if (enabled() && !m_frame_superseded && (m_given_up || elapsed_ms(m_frame_begin) > m_deadline_ms))
+        ++m_missed_count;
+}
+
+barcode_info_t decode_deadline_c::decode(decoder_c &decoder, const cv::Mat &image, const ZXing::DecodeHints &hints)
+{
+    if (!enabled())
+        return decoder.decode(image, hints);
+
+    barcode_info_t info = make_barcode_info(ZXing::DecodeStatus::NotFound);
+
+    if (m_given_up)
+        return info;
+
+    ZXing::DecodeHints stage_hints[DECODE_STAGE_COUNT] = { hints, hints, hints };
+    double megapixels = std::max(image.total() / 1e6, 0.01);
+    int last_cost = -1; // 2 bits of tryHarder and tryRotate, which make a stage more expensive
+
+    stage_hints[0].setTryHarder(false).setTryRotate(false);
+    stage_hints[1].setTryRotate(false);
+
+    for (int i = 0; i < DECODE_STAGE_COUNT; ++i)
+    {
+        int cost = (stage_hints[i].tryHarder() ? 1 : 0) | (stage_hints[i].tryRotate() ? 2 : 0);
+
+        if (cost <= last_cost)
+            continue;
+        last_cost = cost;
+
+        if (m_stages_run > 0)
+        {
+            double spent_ms = elapsed_ms(m_frame_begin);
+
+            if (m_superseded())
+            {
+                ++m_superseded_count;
+                m_given_up = true;
+                m_frame_superseded = true;
+                break;
+            }
+
+            // A stage never run is started as long as there's any budget left.
+            if (spent_ms >= m_deadline_ms)
+            {
+                m_given_up = true;
+                break;
+            }
+
+            if (m_stage_ewma[i] >= 0 && spent_ms + m_stage_ewma[i] * megapixels > m_deadline_ms)
+            {
+                m_stage_ewma[i] *= EWMA_SKIP_DECAY;
+                m_given_up = true;
+                break;
+            }
+        }
+
+        auto stage_begin = std::chrono::steady_clock::now();
+
+        info = decoder.decode(image, stage_hints[i]);
+        ++m_stages_run;
+
+        double ms_per_megapixel = elapsed_ms(stage_begin) / megapixels;
+
+        if (m_stage_ewma[i] < 0)
+            m_stage_ewma[i] = ms_per_megapixel;
+        else
+            m_stage_ewma[i] += EWMA_ALPHA * (ms_per_megapixel - m_stage_ewma[i]);
+
+        if (barcode_info_ok(info))
+            break;
+    }
+
+    return info;
+}
+
+void decode_deadline_c::dump(FILE *stream) const
+{
+    fprintf(stream, "deadline: budget=%.1fms missed=%llu superseded=%llu cost(ms/MP):", m_deadline_ms,
+        (unsigned long long)m_missed_count, (unsigned long long)m_superseded_count);
+    for (int i = 0; i < DECODE_STAGE_COUNT; ++i)
+    {
+        fprintf(stream, " %s=%.1f", STAGE_NAMES[i], m_stage_ewma[i]);
+    }
+    fprintf(stream, "\n");
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Decay estimates of skipped stages, and count every frame finishing past the deadline as missed.
+ */
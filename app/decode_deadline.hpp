@@ -0,0 +1,106 @@
+/*
+ * Decoding of a frame in escalating stages within a deadline.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __DECODE_DEADLINE_HPP__
+#define __DECODE_DEADLINE_HPP__
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <functional>
+
+#include <opencv2/core/mat.hpp>
+#include <ZXing/DecodeHints.h>
+
+#include "barcode_info.hpp"
+
+class decoder_c;
+
+#define DECODE_STAGE_COUNT              3
+
+/*
+ * Each frame is decoded in stages from cheap to expensive, until one succeeds:
+ *   1) fast: neither tryHarder nor tryRotate;
+ *   2) harder: tryHarder as configured, still without tryRotate;
+ *   3) full: hints as configured.
+ * Stages no more expensive than the previous one are left out.
+ * A call to a decoder can't be interrupted, so the cost of each stage is estimated by a moving average
+ * of its past runs (per megapixel), and a stage is started only if it would finish within the deadline
+ * and no newer frame is waiting. Otherwise the frame is given up as superseded, or as missed.
+ * The estimate of a stage decays each time it's skipped, so that the stage is probed again sooner or later
+ * instead of being shut out for good by a few slow runs (cold start of decoder, or a hard frame).
+ * The first stage always runs, so that something is decoded however overloaded.
+ * Any frame finishing past the deadline is counted as missed too, whether given up or not.
+ */
+class decode_deadline_c
+{
+public:
+    // Disabled if deadline_ms is not positive, and images are decoded with hints as they are.
+    // Superseded returns true if a newer frame is waiting.
+    decode_deadline_c(float deadline_ms, const std::function<bool(void)> &superseded);
+
+public:
+    bool enabled(void) const
+    {
+        return m_deadline_ms > 0;
+    }
+
+    // Called before decoding each frame, which may take several calls to decode().
+    void start_frame(void);
+
+    barcode_info_t decode(decoder_c &decoder, const cv::Mat &image, const ZXing::DecodeHints &hints);
+
+    // Called after decoding each frame.
+    void finish_frame(void);
+
+    uint64_t missed_count(void) const
+    {
+        return m_missed_count;
+    }
+
+    uint64_t superseded_count(void) const
+    {
+        return m_superseded_count;
+    }
+
+    void dump(FILE *stream) const;
+
+private:
+    const float m_deadline_ms;
+    const std::function<bool(void)> m_superseded;
+    std::chrono::steady_clock::time_point m_frame_begin;
+    int m_stages_run; // of the current frame
+    bool m_given_up; // the current frame
+    bool m_frame_superseded;
+    uint64_t m_missed_count;
+    uint64_t m_superseded_count;
+    double m_stage_ewma[DECODE_STAGE_COUNT]; // in ms per megapixel, negative if never run
+};
+
+#endif /* #ifndef __DECODE_DEADLINE_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Decay estimates of skipped stages, and count every frame finishing past the deadline as missed.
+ */
@@ -0,0 +1,391 @@
+/*
+ * Decoder engines, and racing or falling back between them.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "decoder_engine.hpp"
+
+#include <stdio.h>
+#include <errno.h>
+
+#include <sstream>
+
+#include <opencv2/objdetect.hpp>
+#if __has_include(<opencv2/objdetect/barcode.hpp>) // since OpenCV 4.8
+#include <opencv2/objdetect/barcode.hpp>
+#define HAS_OPENCV_BARCODE
+#endif
+#include <ZXing/ReadBarcode.h>
+#include <ZXing/Result.h>
+
+static inline bool wants_format(const ZXing::BarcodeFormats &formats, ZXing::BarcodeFormat format)
+{
+    return formats.empty() || formats.testFlag(format); // empty means any
+}
+
+class zxing_engine_c : public decoder_engine_c
+{
+public:
+    const char* name(void) const override
+    {
+        return "zxing";
+    }
+
+    bool supports(const ZXing::BarcodeFormats &formats) const override
+    {
+        return true;
+    }
+
+    barcode_info_t decode(const cv::Mat &image, const ZXing::DecodeHints &hints) override
+    {
+        auto img_view = ZXing::ImageView(image.data, image.cols, image.rows,
+            (1 == image.channels()) ? ZXing::ImageFormat::Lum : ZXing::ImageFormat::BGR, image.step);
+
+        return make_barcode_info(ZXing::ReadBarcode(img_view, hints));
+    }
+};
+
+class opencv_qr_engine_c : public decoder_engine_c
+{
+public:
+    const char* name(void) const override
+    {
+        return "opencv-qr";
+    }
+
+    bool supports(const ZXing::BarcodeFormats &formats) const override
+    {
+        return wants_format(formats, ZXing::BarcodeFormat::QRCode);
+    }
+
+    barcode_info_t decode(const cv::Mat &image, const ZXing::DecodeHints &hints) override
+    {
+        std::vector<cv::Point2f> points;
+        std::string text = m_detector.detectAndDecode(image, points);
+        barcode_info_t info = make_barcode_info(ZXing::DecodeStatus::NotFound);
+
+        if (text.empty() || points.size() < 4)
+            return info;
+
+        info.status = ZXing::DecodeStatus::NoError;
+        info.format = ZXing::BarcodeFormat::QRCode;
+        info.text = text;
+        for (int i = 0; i < 4; ++i)
+        {
+            info.position[i] = points[i]; // already in the order of top-left, top-right, bottom-right, bottom-left
+        }
+
+        return info;
+    }
+
+private:
+    cv::QRCodeDetector m_detector;
+};
+
+#ifdef HAS_OPENCV_BARCODE
+
+class opencv_barcode_engine_c : public decoder_engine_c
+{
+public:
+    const char* name(void) const override
+    {
+        return "opencv-barcode";
+    }
+
+    bool supports(const ZXing::BarcodeFormats &formats) const override
+    {
+        for (auto format : { ZXing::BarcodeFormat::EAN8, ZXing::BarcodeFormat::EAN13,
+            ZXing::BarcodeFormat::UPCA, ZXing::BarcodeFormat::UPCE })
+        {
+            if (wants_format(formats, format))
+                return true;
+        }
+
+        return false;
+    }
+
+    barcode_info_t decode(const cv::Mat &image, const ZXing::DecodeHints &hints) override
+    {
+        std::vector<std::string> texts;
+        std::vector<std::string> types;
+        std::vector<cv::Point2f> points;
+        barcode_info_t info = make_barcode_info(ZXing::DecodeStatus::NotFound);
+
+        if (!m_detector.detectAndDecodeWithType(image, texts, types, points))
+            return info;
+
+        for (size_t i = 0; i < texts.size() && i < types.size() && (i + 1) * 4 <= points.size(); ++i)
+        {
+            ZXing::BarcodeFormat format = type_to_format(types[i]);
+
+            if (texts[i].empty() || ZXing::BarcodeFormat::None == format || !wants_format(hints.formats(), format))
+                continue;
+
+            const cv::Point2f *corners = &points[i * 4]; // bottom-left, top-left, top-right, bottom-right
+
+            info.status = ZXing::DecodeStatus::NoError;
+            info.format = format;
+            info.text = texts[i];
+            info.position[0] = corners[1];
+            info.position[1] = corners[2];
+            info.position[2] = corners[3];
+            info.position[3] = corners[0];
+            break;
+        }
+
+        return info;
+    }
+
+private:
+    static ZXing::BarcodeFormat type_to_format(const std::string &type)
+    {
+        if ("EAN_13" == type)
+            return ZXing::BarcodeFormat::EAN13;
+        else if ("EAN_8" == type)
+            return ZXing::BarcodeFormat::EAN8;
+        else if ("UPC_A" == type)
+            return ZXing::BarcodeFormat::UPCA;
+        else if ("UPC_E" == type)
+            return ZXing::BarcodeFormat::UPCE;
+        else
+            return ZXing::BarcodeFormat::None;
+    }
+
+private:
+    cv::barcode::BarcodeDetector m_detector;
+};
+
+#endif // #ifdef HAS_OPENCV_BARCODE
+
+decoder_engine_c* decoder_engine_c::create(const std::string &name)
+{
+    if ("zxing" == name)
+        return new zxing_engine_c();
+    else if ("opencv-qr" == name)
+        return new opencv_qr_engine_c();
+#ifdef HAS_OPENCV_BARCODE
+    else if ("opencv-barcode" == name)
+        return new opencv_barcode_engine_c();
+#endif
+    else
+        return nullptr;
+}
+
+decoder_c::decoder_c()
+    : m_race_mode(false)
+    , m_stopping(false)
+    , m_last_winner(nullptr)
+    , m_generation(0)
+    , m_pending(0)
+    , m_has_winner(false)
+    , m_winner_name(nullptr)
+    , m_busy_skip_count(0)
+{
+}
+
+decoder_c::~decoder_c()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        m_stopping = true;
+    }
+    m_job_cond.notify_all();
+
+    for (auto &racer : m_racers)
+    {
+        racer->thread.join();
+    }
+}
+
+int decoder_c::init(const std::string &names, const std::string &mode)
+{
+    std::istringstream stream(names);
+    std::string name;
+
+    while (std::getline(stream, name, ','))
+    {
+        decoder_engine_c *engine = decoder_engine_c::create(name);
+
+        if (nullptr == engine)
+        {
+            fprintf(stderr, "*** Unknown or unavailable decoder engine: %s\n", name.c_str());
+            return -EINVAL;
+        }
+
+        m_engines.emplace_back(engine);
+    }
+
+    if (m_engines.empty())
+    {
+        fprintf(stderr, "*** No decoder engine specified!\n");
+        return -EINVAL;
+    }
+
+    // A race of a single engine would be nothing but a cascade with an extra thread.
+    if ("race" == mode && m_engines.size() > 1)
+    {
+        for (auto &engine : m_engines)
+        {
+            racer_t *racer = new racer_t();
+
+            racer->engine = std::move(engine);
+            racer->busy = false;
+            racer->has_job = false;
+            racer->generation = 0;
+            m_racers.emplace_back(racer);
+            racer->thread = std::thread(&decoder_c::race_routine, this, racer);
+        }
+        m_engines.clear();
+    }
+
+    m_race_mode = !m_racers.empty();
+
+    return 0;
+}
+
+barcode_info_t decoder_c::decode(const cv::Mat &image, const ZXing::DecodeHints &hints)
+{
+    return m_race_mode ? decode_in_race(image, hints) : decode_in_cascade(image, hints);
+}
+
+barcode_info_t decoder_c::decode_in_cascade(const cv::Mat &image, const ZXing::DecodeHints &hints)
+{
+    barcode_info_t info = make_barcode_info(ZXing::DecodeStatus::NotFound);
+    auto formats = hints.formats();
+
+    m_last_winner = nullptr;
+    for (auto &engine : m_engines)
+    {
+        if (!engine->supports(formats))
+            continue;
+
+        if (barcode_info_ok(info = engine->decode(image, hints)))
+        {
+            m_last_winner = engine->name();
+            break;
+        }
+    }
+
+    return info;
+}
+
+barcode_info_t decoder_c::decode_in_race(const cv::Mat &image, const ZXing::DecodeHints &hints)
+{
+    auto formats = hints.formats();
+    barcode_info_t info = make_barcode_info(ZXing::DecodeStatus::NotFound);
+    cv::Mat shared_image; // The caller is free to reuse its image once this function returns.
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    m_last_winner = nullptr;
+    ++m_generation;
+    m_pending = 0;
+    m_has_winner = false;
+
+    while (true)
+    {
+        int supported = 0;
+        int busy = 0;
+
+        for (auto &racer : m_racers)
+        {
+            if (!racer->engine->supports(formats))
+                continue;
+
+            ++supported;
+            if (racer->busy)
+            {
+                ++busy;
+                continue;
+            }
+
+            if (shared_image.empty())
+                shared_image = image.clone();
+            racer->image = shared_image;
+            racer->hints = hints;
+            racer->generation = m_generation;
+            racer->has_job = true;
+            racer->busy = true;
+            ++m_pending;
+        }
+
+        if (m_pending > 0 || 0 == supported)
+        {
+            m_busy_skip_count += busy;
+            break;
+        }
+
+        m_result_cond.wait(lock); // all busy, notified whenever a racer is done
+    }
+    m_job_cond.notify_all();
+
+    m_result_cond.wait(lock, [this] { return m_has_winner || 0 == m_pending; });
+    if (m_has_winner)
+    {
+        m_last_winner = m_winner_name;
+        info = m_winner_info;
+    }
+
+    return info;
+}
+
+void decoder_c::race_routine(racer_t *racer)
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    while (true)
+    {
+        m_job_cond.wait(lock, [this, racer] { return m_stopping || racer->has_job; });
+        if (m_stopping)
+            break;
+
+        uint64_t generation = racer->generation;
+        cv::Mat image = racer->image;
+        ZXing::DecodeHints hints = racer->hints;
+
+        racer->has_job = false;
+        lock.unlock();
+
+        barcode_info_t info = racer->engine->decode(image, hints);
+
+        image.release();
+        lock.lock();
+        racer->busy = false;
+        racer->image.release();
+        if (generation == m_generation) // otherwise too late
+        {
+            --m_pending;
+            if (barcode_info_ok(info) && !m_has_winner)
+            {
+                m_has_winner = true;
+                m_winner_info = info;
+                m_winner_name = racer->engine->name();
+            }
+        }
+        m_result_cond.notify_all(); // also to a caller waiting for a free racer
+    }
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Make results of NotFound through make_barcode_info().
+ *  03. Run all engines on racer threads in race mode, and count engines left out for being busy.
+ */
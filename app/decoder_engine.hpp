@@ -0,0 +1,143 @@
+/*
+ * Decoder engines, and racing or falling back between them.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __DECODER_ENGINE_HPP__
+#define __DECODER_ENGINE_HPP__
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <opencv2/core/mat.hpp>
+#include <ZXing/DecodeHints.h>
+
+#include "barcode_info.hpp"
+
+#define DECODER_ENGINE_CANDIDATES       "zxing,opencv-qr,opencv-barcode"
+
+class decoder_engine_c
+{
+public:
+    virtual ~decoder_engine_c()
+    {
+    }
+
+public:
+    virtual const char* name(void) const = 0;
+
+    // Returns true if the engine is able to decode any of the formats.
+    virtual bool supports(const ZXing::BarcodeFormats &formats) const = 0;
+
+    // Image is either luma or BGR, and the position of result is relative to it.
+    virtual barcode_info_t decode(const cv::Mat &image, const ZXing::DecodeHints &hints) = 0;
+
+    // Returns null if the name is unknown or the engine is not built in.
+    static decoder_engine_c* create(const std::string &name);
+};
+
+/*
+ * Engines are tried in the order of their names, and those not supporting any of the formats of hints are skipped:
+ *   1) in cascade mode, one after another on the calling thread until one succeeds,
+ *      so cheap engines are expected to be put first;
+ *   2) in race mode, every engine runs on a thread of its own against a shared copy of the image,
+ *      and the caller returns as soon as the first success comes, or all engines have failed.
+ *      Engines still busy with a previous image are left out (and counted), and their late results are discarded,
+ *      so that a slow engine never holds up the caller for more than one image. If all of them are busy,
+ *      the caller waits for the first one to be free, rather than returning without decoding anything.
+ */
+class decoder_c
+{
+public:
+    decoder_c();
+
+    ~decoder_c();
+
+public:
+    // Names are separated by comma, mode is one of "cascade" and "race".
+    int init(const std::string &names, const std::string &mode);
+
+    barcode_info_t decode(const cv::Mat &image, const ZXing::DecodeHints &hints);
+
+    // Engine which produced the last successful result, or null.
+    const char* last_winner(void) const
+    {
+        return m_last_winner;
+    }
+
+    // Times engines are left out of a race for being busy with a previous image.
+    uint64_t busy_skip_count(void) const
+    {
+        return m_busy_skip_count;
+    }
+
+    bool race_mode(void) const
+    {
+        return m_race_mode;
+    }
+
+private:
+    struct racer_t
+    {
+        std::unique_ptr<decoder_engine_c> engine;
+        std::thread thread;
+        bool busy;
+        bool has_job;
+        uint64_t generation;
+        cv::Mat image;
+        ZXing::DecodeHints hints;
+    };
+
+    barcode_info_t decode_in_cascade(const cv::Mat &image, const ZXing::DecodeHints &hints);
+
+    barcode_info_t decode_in_race(const cv::Mat &image, const ZXing::DecodeHints &hints);
+
+    void race_routine(racer_t *racer);
+
+private:
+    std::vector<std::unique_ptr<decoder_engine_c>> m_engines;
+    std::vector<std::unique_ptr<racer_t>> m_racers;
+    bool m_race_mode;
+    bool m_stopping;
+    const char *m_last_winner;
+    std::mutex m_lock;
+    std::condition_variable m_job_cond;
+    std::condition_variable m_result_cond;
+    uint64_t m_generation;
+    int m_pending;
+    bool m_has_winner;
+    barcode_info_t m_winner_info;
+    const char *m_winner_name;
+    uint64_t m_busy_skip_count;
+};
+
+#endif /* #ifndef __DECODER_ENGINE_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Run all engines on racer threads in race mode, and count engines left out for being busy.
+ */
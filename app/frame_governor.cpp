@@ -0,0 +1,171 @@
+/*
+ * Feedback controller of capture FPS, decode resolution and frame skipping.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "frame_governor.hpp"
+
+#include <algorithm>
+
+#define EWMA_ALPHA                      0.2
+#define ADJUST_PERIOD                   8 // in decoded frames
+#define HIGH_WATERMARK                  1.1 // of the budget
+#define LOW_WATERMARK                   0.6 // of the budget
+#define DROP_WATERMARK                  0.5 // in dropped frames per decoded frame
+
+#define SCALE_MIN                       0.25f
+#define SCALE_STEP                      0.8f
+#define FPS_MIN                         1.0f
+#define FPS_STEP                        0.8f
+#define SKIP_RATIO_MAX                  8
+
+frame_governor_c::frame_governor_c(float latency_budget_ms, float max_fps)
+    : m_budget_ms(latency_budget_ms)
+    , m_max_fps(max_fps)
+    , m_fps(max_fps)
+    , m_scale(1.0f)
+    , m_skip_ratio(1)
+    , m_skip_counter(0)
+    , m_frames_since_adjust(0)
+    , m_decode_ewma(-1)
+    , m_latency_ewma(-1)
+    , m_drop_ewma(0)
+    , m_fps_changed(false)
+{
+}
+
+bool frame_governor_c::should_skip(void)
+{
+    if (m_skip_ratio <= 1)
+        return false;
+
+    if (++m_skip_counter < m_skip_ratio)
+        return true;
+
+    m_skip_counter = 0;
+
+    return false;
+}
+
+void frame_governor_c::feed(double decode_ms, double age_ms, int dropped_frames)
+{
+    // Latency as measured from capture to the end of decoding, including waits in driver buffers and handoff slots.
+    double latency_ms = std::max(age_ms, 0.0) + decode_ms;
+
+    if (m_decode_ewma < 0)
+    {
+        m_decode_ewma = decode_ms;
+        m_latency_ewma = latency_ms;
+        m_drop_ewma = dropped_frames;
+    }
+    else
+    {
+        m_decode_ewma += EWMA_ALPHA * (decode_ms - m_decode_ewma);
+        m_latency_ewma += EWMA_ALPHA * (latency_ms - m_latency_ewma);
+        m_drop_ewma += EWMA_ALPHA * (dropped_frames - m_drop_ewma);
+    }
+
+    if (!enabled() || ++m_frames_since_adjust < ADJUST_PERIOD)
+        return;
+
+    m_frames_since_adjust = 0;
+    adjust();
+}
+
+void frame_governor_c::adjust(void)
+{
+    float fps_min = std::min(FPS_MIN, m_max_fps);
+
+    if (m_latency_ewma > m_budget_ms * HIGH_WATERMARK)
+    {
+        if (m_decode_ewma > m_budget_ms && m_scale > SCALE_MIN)
+            m_scale = std::max(SCALE_MIN, m_scale * SCALE_STEP);
+        else if (m_drop_ewma > DROP_WATERMARK && m_fps > fps_min)
+        {
+            // No need to capture faster than the decoder can consume.
+            float decodable_fps = (m_decode_ewma > 0) ? (float)(1000.0 / m_decode_ewma) : m_fps;
+
+            m_fps = std::max(fps_min, std::min(m_fps * FPS_STEP, decodable_fps));
+            m_fps_changed = true;
+        }
+        else if (m_skip_ratio < SKIP_RATIO_MAX)
+            ++m_skip_ratio;
+        else if (m_scale > SCALE_MIN)
+            m_scale = std::max(SCALE_MIN, m_scale * SCALE_STEP);
+        else
+        {
+            // Nothing left to sacrifice.
+        }
+    }
+    else if (m_latency_ewma < m_budget_ms * LOW_WATERMARK && m_drop_ewma < DROP_WATERMARK)
+    {
+        if (m_skip_ratio > 1)
+        {
+            --m_skip_ratio;
+            m_skip_counter = 0;
+        }
+        else if (m_fps < m_max_fps)
+        {
+            m_fps = std::min(m_max_fps, m_fps / FPS_STEP);
+            m_fps_changed = true;
+        }
+        else if (m_scale < 1.0f)
+            m_scale = std::min(1.0f, m_scale / SCALE_STEP);
+        else
+        {
+            // Already at full quality.
+        }
+    }
+    else
+    {
+        // Within the hysteresis band, keep everything as it is.
+    }
+}
+
+bool frame_governor_c::take_fps_change(float &fps)
+{
+    if (!m_fps_changed)
+        return false;
+
+    fps = m_fps;
+    m_fps_changed = false;
+
+    return true;
+}
+
+void frame_governor_c::set_max_fps(float max_fps)
+{
+    m_max_fps = max_fps;
+    m_fps = max_fps;
+    m_fps_changed = true;
+}
+
+void frame_governor_c::dump(FILE *stream) const
+{
+    fprintf(stream, "governor: budget=%.1fms latency=%.1fms decode=%.1fms dropped=%.2f fps=%.1f scale=%.2f skip=1/%d\n",
+        m_budget_ms, m_latency_ewma, m_decode_ewma, m_drop_ewma, m_fps, m_scale, m_skip_ratio);
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Add set_max_fps().
+ *  03. Feed measured age of frames and dropped frames instead of an estimated queue depth.
+ */
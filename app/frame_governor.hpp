@@ -0,0 +1,105 @@
+/*
+ * Feedback controller of capture FPS, decode resolution and frame skipping.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __FRAME_GOVERNOR_HPP__
+#define __FRAME_GOVERNOR_HPP__
+
+#include <stdio.h>
+
+/*
+ * Knobs are turned one step at a time, and only once per adjustment period,
+ * in the following order when overloaded (and the reverse order when idle):
+ *   1) decode resolution, if decoding itself is too slow;
+ *   2) capture FPS, if frames arrive faster than they can be decoded (and are dropped);
+ *   3) skip ratio, if FPS has already reached its lower bound.
+ */
+class frame_governor_c
+{
+public:
+    frame_governor_c(float latency_budget_ms, float max_fps);
+
+public:
+    bool enabled(void) const
+    {
+        return m_budget_ms > 0;
+    }
+
+    // Called once per captured frame, returns true if the frame should be grabbed but not decoded.
+    bool should_skip(void);
+
+    // Called once per decoded frame, with the age of frame (from capture to the start of decoding)
+    // and the number of frames dropped since the previous call, for being superseded before decoding.
+    void feed(double decode_ms, double age_ms, int dropped_frames);
+
+    // Returns true (only once for each change) if capture FPS needs to be re-applied to device.
+    bool take_fps_change(float &fps);
+
+    // Changes the upper bound of FPS at runtime, and restarts from it.
+    void set_max_fps(float max_fps);
+
+    float fps(void) const
+    {
+        return m_fps;
+    }
+
+    float scale(void) const
+    {
+        return m_scale;
+    }
+
+    int skip_ratio(void) const
+    {
+        return m_skip_ratio;
+    }
+
+    double latency_ms(void) const
+    {
+        return m_latency_ewma;
+    }
+
+    void dump(FILE *stream) const;
+
+private:
+    void adjust(void);
+
+private:
+    const float m_budget_ms;
+    float m_max_fps;
+    float m_fps;
+    float m_scale;
+    int m_skip_ratio;
+    int m_skip_counter;
+    int m_frames_since_adjust;
+    double m_decode_ewma;
+    double m_latency_ewma;
+    double m_drop_ewma; // dropped frames per decoded frame
+    bool m_fps_changed;
+};
+
+#endif /* #ifndef __FRAME_GOVERNOR_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Add set_max_fps().
+ *  03. Feed measured age of frames and dropped frames instead of an estimated queue depth.
+ */
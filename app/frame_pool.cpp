@@ -0,0 +1,247 @@
+/*
+ * Pooled allocator of frame buffers.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "frame_pool.hpp"
+
+#include <stdlib.h>
+
+#include <new>
+
+#define FRAME_POOL_MIN_SIZE             (320 * 240)
+#define SLAB_GRANULARITY                4096
+#define SLAB_ALIGNMENT                  64 // cache line
+
+// Tags in UMatData::allocatorFlags_.
+#define SLAB_POOLED                     1
+#define SLAB_OVERFLOW                   2
+
+static size_t slab_size_of(size_t size)
+{
+    return (size + SLAB_GRANULARITY - 1) / SLAB_GRANULARITY * SLAB_GRANULARITY;
+}
+
+static void* alloc_slab(size_t size)
+{
+    void *slab = nullptr;
+
+    return (0 == posix_memalign(&slab, SLAB_ALIGNMENT, size)) ? slab : nullptr;
+}
+
+frame_pool_c::frame_pool_c(size_t cap_bytes)
+    : m_cap_bytes(cap_bytes)
+    , m_held_bytes(0)
+    , m_idle_bytes(0)
+    , m_hits(0)
+    , m_misses(0)
+    , m_overflows(0)
+{
+}
+
+frame_pool_c::~frame_pool_c()
+{
+    for (auto &iter : m_idle_slabs)
+    {
+        for (void *slab : iter.second)
+        {
+            free(slab);
+        }
+    }
+
+    for (void *record : m_idle_records)
+    {
+        ::operator delete(record);
+    }
+}
+
+// Frees idle slabs, the biggest first, until there's room for the wanted size or nothing idle is left.
+void frame_pool_c::evict(size_t wanted) const
+{
+    for (auto iter = m_idle_slabs.rbegin(); iter != m_idle_slabs.rend() && m_held_bytes + wanted > m_cap_bytes; ++iter)
+    {
+        auto &slabs = iter->second;
+
+        while (!slabs.empty() && m_held_bytes + wanted > m_cap_bytes)
+        {
+            free(slabs.back());
+            slabs.pop_back();
+            m_held_bytes -= iter->first;
+            m_idle_bytes -= iter->first;
+        }
+    }
+}
+
+// Returns null if the cap is reached.
+void* frame_pool_c::acquire_slab(size_t size) const
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    auto iter = m_idle_slabs.find(size);
+
+    if (m_idle_slabs.end() != iter && !iter->second.empty())
+    {
+        void *slab = iter->second.back();
+
+        iter->second.pop_back();
+        m_idle_bytes -= size;
+        ++m_hits;
+
+        return slab;
+    }
+
+    ++m_misses;
+    if (m_held_bytes + size > m_cap_bytes)
+        evict(size);
+    if (m_held_bytes + size > m_cap_bytes)
+    {
+        ++m_overflows;
+        return nullptr;
+    }
+    m_held_bytes += size;
+    lock.unlock();
+
+    void *slab = alloc_slab(size);
+
+    if (nullptr == slab)
+    {
+        lock.lock();
+        m_held_bytes -= size;
+    }
+
+    return slab;
+}
+
+void frame_pool_c::release_slab(void *slab, size_t size) const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    // The vector keeps its capacity, so that pushing back allocates nothing in steady state.
+    m_idle_slabs[size].push_back(slab);
+    m_idle_bytes += size;
+}
+
+cv::UMatData* frame_pool_c::new_umat_data(void) const
+{
+    void *storage = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        if (!m_idle_records.empty())
+        {
+            storage = m_idle_records.back();
+            m_idle_records.pop_back();
+        }
+    }
+
+    if (nullptr == storage)
+        storage = ::operator new(sizeof(cv::UMatData));
+
+    return new (storage) cv::UMatData(this);
+}
+
+void frame_pool_c::delete_umat_data(cv::UMatData *data) const
+{
+    data->~UMatData();
+
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    m_idle_records.push_back(data);
+}
+
+cv::UMatData* frame_pool_c::allocate(int dims, const int *sizes, int type, void *data, size_t *step,
+    cv::AccessFlag flags, cv::UMatUsageFlags usage_flags) const
+{
+    size_t total = CV_ELEM_SIZE(type);
+
+    for (int i = 0; i < dims; ++i)
+    {
+        total *= sizes[i];
+    }
+
+    if (nullptr != data || total < FRAME_POOL_MIN_SIZE)
+        return cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usage_flags);
+
+    // Rows are packed, as what the standard allocator does.
+    if (nullptr != step)
+    {
+        size_t stride = CV_ELEM_SIZE(type);
+
+        for (int i = dims - 1; i >= 0; --i)
+        {
+            step[i] = stride;
+            stride *= sizes[i];
+        }
+    }
+
+    size_t slab_size = slab_size_of(total);
+    void *slab = acquire_slab(slab_size);
+    int tag = SLAB_POOLED;
+
+    if (nullptr == slab)
+    {
+        if (nullptr == (slab = alloc_slab(slab_size)))
+            CV_Error_(cv::Error::StsNoMem, ("Failed to allocate %zu bytes", slab_size));
+        tag = SLAB_OVERFLOW;
+    }
+
+    cv::UMatData *u = new_umat_data();
+
+    u->data = u->origdata = (uchar *)slab;
+    u->size = total;
+    u->allocatorFlags_ = tag;
+
+    return u;
+}
+
+bool frame_pool_c::allocate(cv::UMatData *data, cv::AccessFlag access_flags, cv::UMatUsageFlags usage_flags) const
+{
+    return false; // no device memory
+}
+
+void frame_pool_c::deallocate(cv::UMatData *data) const
+{
+    if (nullptr == data)
+        return;
+
+    CV_Assert(0 == data->urefcount && 0 == data->refcount);
+
+    if (SLAB_POOLED == data->allocatorFlags_)
+        release_slab(data->origdata, slab_size_of(data->size));
+    else
+        free(data->origdata);
+    data->origdata = nullptr;
+
+    delete_umat_data(data);
+}
+
+void frame_pool_c::dump(FILE *stream) const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    fprintf(stream, "frame_pool: held=%.1fMB idle=%.1fMB cap=%.1fMB hits=%llu misses=%llu overflows=%llu\n",
+        m_held_bytes / 1048576.0, m_idle_bytes / 1048576.0, m_cap_bytes / 1048576.0,
+        (unsigned long long)m_hits, (unsigned long long)m_misses, (unsigned long long)m_overflows);
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ */
@@ -0,0 +1,92 @@
+/*
+ * Pooled allocator of frame buffers.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __FRAME_POOL_HPP__
+#define __FRAME_POOL_HPP__
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <map>
+#include <vector>
+#include <mutex>
+
+#include <opencv2/core/mat.hpp>
+
+/*
+ * Buffers of matrices no smaller than a frame of QVGA (rounded up to pages, and aligned to cache lines)
+ * are recycled by size once released, instead of going back to heap, so that frames of the same size
+ * reuse the same slabs and steady state allocates nothing. Smaller ones are left to the standard allocator.
+ * Bookkeeping records of OpenCV (UMatData) are recycled too.
+ *
+ * The cap bounds the memory held by the pool, both in use and idle. Idle slabs of other sizes are freed
+ * to make room first, and requests still beyond the cap are served by heap without pooling and counted
+ * as overflows, rather than failing the frame.
+ *
+ * All methods are thread-safe. The pool must outlive every matrix allocated by it.
+ */
+class frame_pool_c : public cv::MatAllocator
+{
+public:
+    frame_pool_c(size_t cap_bytes);
+
+    ~frame_pool_c();
+
+public:
+    cv::UMatData* allocate(int dims, const int *sizes, int type, void *data, size_t *step,
+        cv::AccessFlag flags, cv::UMatUsageFlags usage_flags) const override;
+
+    bool allocate(cv::UMatData *data, cv::AccessFlag access_flags, cv::UMatUsageFlags usage_flags) const override;
+
+    void deallocate(cv::UMatData *data) const override;
+
+    void dump(FILE *stream) const;
+
+private:
+    void* acquire_slab(size_t size) const;
+
+    void release_slab(void *slab, size_t size) const;
+
+    void evict(size_t wanted) const;
+
+    cv::UMatData* new_umat_data(void) const;
+
+    void delete_umat_data(cv::UMatData *data) const;
+
+private:
+    const size_t m_cap_bytes;
+    mutable std::mutex m_lock;
+    mutable std::map<size_t, std::vector<void *>> m_idle_slabs; // by size
+    mutable std::vector<void *> m_idle_records; // storage of UMatData
+    mutable size_t m_held_bytes; // in use and idle
+    mutable size_t m_idle_bytes;
+    mutable uint64_t m_hits;
+    mutable uint64_t m_misses;
+    mutable uint64_t m_overflows;
+};
+
+#endif /* #ifndef __FRAME_POOL_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ */
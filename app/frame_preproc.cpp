@@ -0,0 +1,395 @@
+/*
+ * Preprocessing of frames before barcode detection.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "frame_preproc.hpp"
+
+#include <stdlib.h>
+
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define PREPROC_SIMD_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PREPROC_SIMD_NEON
+#endif
+
+#define PREPROC_TILE_SIZE               32
+#define STRETCH_MIN_RANGE               24 // Flatter tiles are left as they are, or noise would be amplified.
+#define CLAHE_CLIP_LIMIT                2.0
+#define ROI_MIN_ENERGY                  8.0f // average gradient per pixel
+#define ROI_ENERGY_RATIO                0.5f // of the max energy among tiles
+#define ROI_MAX_AREA_RATIO              0.75f // of the whole image, otherwise not worth it
+
+/*
+ * ====================
+ *   Row kernels
+ * ====================
+ */
+
+static void row_min_max(const uint8_t *p, int n, uint8_t &lo, uint8_t &hi)
+{
+    int i = 0;
+
+#if defined(PREPROC_SIMD_SSE2) || defined(PREPROC_SIMD_NEON)
+    if (n >= 16)
+    {
+        alignas(16) uint8_t mins[16];
+        alignas(16) uint8_t maxs[16];
+
+#if defined(PREPROC_SIMD_SSE2)
+        __m128i vmin = _mm_set1_epi8((char)0xFF);
+        __m128i vmax = _mm_setzero_si128();
+
+        for (; i + 16 <= n; i += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+
+            vmin = _mm_min_epu8(vmin, v);
+            vmax = _mm_max_epu8(vmax, v);
+        }
+        _mm_store_si128((__m128i *)mins, vmin);
+        _mm_store_si128((__m128i *)maxs, vmax);
+#else
+        uint8x16_t vmin = vdupq_n_u8(0xFF);
+        uint8x16_t vmax = vdupq_n_u8(0);
+
+        for (; i + 16 <= n; i += 16)
+        {
+            uint8x16_t v = vld1q_u8(p + i);
+
+            vmin = vminq_u8(vmin, v);
+            vmax = vmaxq_u8(vmax, v);
+        }
+        vst1q_u8(mins, vmin);
+        vst1q_u8(maxs, vmax);
+#endif
+        for (int j = 0; j < 16; ++j)
+        {
+            lo = std::min(lo, mins[j]);
+            hi = std::max(hi, maxs[j]);
+        }
+    }
+#endif
+
+    for (; i < n; ++i)
+    {
+        lo = std::min(lo, p[i]);
+        hi = std::max(hi, p[i]);
+    }
+}
+
+// dst[i] = (src[i] - lo) * gain / 256, saturated to [0, 255]. In-place operation is allowed.
+static void row_stretch(const uint8_t *src, uint8_t *dst, int n, uint8_t lo, uint16_t gain)
+{
+    int i = 0;
+
+#if defined(PREPROC_SIMD_SSE2)
+    const __m128i vlo = _mm_set1_epi8((char)lo);
+    const __m128i vgain = _mm_set1_epi16((short)gain);
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i d = _mm_subs_epu8(_mm_loadu_si128((const __m128i *)(src + i)), vlo);
+        // (d << 8) * gain >> 16 == d * gain / 256
+        __m128i r_lo = _mm_mulhi_epu16(_mm_unpacklo_epi8(zero, d), vgain);
+        __m128i r_hi = _mm_mulhi_epu16(_mm_unpackhi_epi8(zero, d), vgain);
+
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(r_lo, r_hi));
+    }
+#elif defined(PREPROC_SIMD_NEON)
+    const uint8x16_t vlo = vdupq_n_u8(lo);
+
+    for (; i + 16 <= n; i += 16)
+    {
+        uint8x16_t d = vqsubq_u8(vld1q_u8(src + i), vlo);
+        // 2 * (d << 7) * gain >> 16 == d * gain / 256
+        int16x8_t r_lo = vqdmulhq_n_s16(vreinterpretq_s16_u16(vshll_n_u8(vget_low_u8(d), 7)), (int16_t)gain);
+        int16x8_t r_hi = vqdmulhq_n_s16(vreinterpretq_s16_u16(vshll_n_u8(vget_high_u8(d), 7)), (int16_t)gain);
+
+        vst1q_u8(dst + i, vcombine_u8(vqmovun_s16(r_lo), vqmovun_s16(r_hi)));
+    }
+#endif
+
+    for (; i < n; ++i)
+    {
+        int d = (src[i] > lo) ? (src[i] - lo) : 0;
+
+        dst[i] = (uint8_t)std::min(255, (d * gain) >> 8);
+    }
+}
+
+// Sums of |p[i + 1] - p[i]| for i in [0, nx), and |below[i] - p[i]| for i in [0, ny).
+static void row_gradient_sums(const uint8_t *p, int nx, const uint8_t *below, int ny, uint64_t &gx, uint64_t &gy)
+{
+    int i = 0;
+
+#if defined(PREPROC_SIMD_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = _mm_setzero_si128();
+
+    for (; i + 16 <= nx; i += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(p + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(p + i + 1));
+
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a)), zero));
+    }
+    gx += (uint64_t)_mm_cvtsi128_si32(acc) + (uint64_t)_mm_cvtsi128_si32(_mm_srli_si128(acc, 8));
+#elif defined(PREPROC_SIMD_NEON)
+    uint32x4_t acc = vdupq_n_u32(0);
+
+    // NOTE: Each u16 lane gains at most 2 * 255 per round, so it's safe to widen every round.
+    for (; i + 16 <= nx; i += 16)
+    {
+        acc = vpadalq_u16(acc, vpaddlq_u8(vabdq_u8(vld1q_u8(p + i), vld1q_u8(p + i + 1))));
+    }
+    gx += (uint64_t)vgetq_lane_u32(acc, 0) + vgetq_lane_u32(acc, 1) + vgetq_lane_u32(acc, 2) + vgetq_lane_u32(acc, 3);
+#endif
+    for (; i < nx; ++i)
+    {
+        gx += abs(p[i + 1] - p[i]);
+    }
+
+    if (nullptr == below)
+        return;
+
+    i = 0;
+#if defined(PREPROC_SIMD_SSE2)
+    acc = _mm_setzero_si128();
+    for (; i + 16 <= ny; i += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(p + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(below + i));
+
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a)), zero));
+    }
+    gy += (uint64_t)_mm_cvtsi128_si32(acc) + (uint64_t)_mm_cvtsi128_si32(_mm_srli_si128(acc, 8));
+#elif defined(PREPROC_SIMD_NEON)
+    acc = vdupq_n_u32(0);
+    for (; i + 16 <= ny; i += 16)
+    {
+        acc = vpadalq_u16(acc, vpaddlq_u8(vabdq_u8(vld1q_u8(p + i), vld1q_u8(below + i))));
+    }
+    gy += (uint64_t)vgetq_lane_u32(acc, 0) + vgetq_lane_u32(acc, 1) + vgetq_lane_u32(acc, 2) + vgetq_lane_u32(acc, 3);
+#endif
+    for (; i < ny; ++i)
+    {
+        gy += abs(below[i] - p[i]);
+    }
+}
+
+/*
+ * ====================
+ *   Preprocessor
+ * ====================
+ */
+
+frame_preprocessor_c::frame_preprocessor_c(const std::string &mode, bool roi_assist)
+    : m_mode(("stretch" == mode) ? MODE_STRETCH : (("clahe" == mode) ? MODE_CLAHE : MODE_NONE))
+    , m_roi_assist(roi_assist)
+    , m_tiles_x(0)
+    , m_tiles_y(0)
+{
+    if (MODE_CLAHE == m_mode)
+        m_clahe = cv::createCLAHE(CLAHE_CLIP_LIMIT);
+}
+
+const char* frame_preprocessor_c::simd_name(void)
+{
+#if defined(PREPROC_SIMD_SSE2)
+    return "SSE2";
+#elif defined(PREPROC_SIMD_NEON)
+    return "NEON";
+#else
+    return "none";
+#endif
+}
+
+void frame_preprocessor_c::compute_tile_stats(const cv::Mat &luma)
+{
+    const int T = PREPROC_TILE_SIZE;
+    const bool need_range = (MODE_STRETCH == m_mode);
+    std::vector<uint64_t> energy_sums;
+
+    m_tiles_x = (luma.cols + T - 1) / T;
+    m_tiles_y = (luma.rows + T - 1) / T;
+    m_tile_min.assign(m_tiles_x * m_tiles_y, 0xFF);
+    m_tile_max.assign(m_tiles_x * m_tiles_y, 0);
+    if (m_roi_assist)
+        energy_sums.assign(m_tiles_x * m_tiles_y, 0);
+
+    for (int y = 0; y < luma.rows; ++y)
+    {
+        const uint8_t *row = luma.ptr<uint8_t>(y);
+        const uint8_t *below = (y + 1 < luma.rows) ? luma.ptr<uint8_t>(y + 1) : nullptr;
+        int tile_base = (y / T) * m_tiles_x;
+
+        for (int tx = 0; tx < m_tiles_x; ++tx)
+        {
+            int x0 = tx * T;
+            int n = std::min(T, luma.cols - x0);
+
+            if (need_range)
+                row_min_max(row + x0, n, m_tile_min[tile_base + tx], m_tile_max[tile_base + tx]);
+
+            if (m_roi_assist)
+            {
+                uint64_t gx = 0;
+                uint64_t gy = 0;
+
+                row_gradient_sums(row + x0, std::min(n, luma.cols - x0 - 1), below ? (below + x0) : nullptr, n,
+                    gx, gy);
+                energy_sums[tile_base + tx] += gx + gy;
+            }
+        }
+    }
+
+    if (!m_roi_assist)
+        return;
+
+    m_tile_energy.resize(energy_sums.size());
+    for (int ty = 0; ty < m_tiles_y; ++ty)
+    {
+        for (int tx = 0; tx < m_tiles_x; ++tx)
+        {
+            int pixels = std::min(T, luma.cols - tx * T) * std::min(T, luma.rows - ty * T);
+
+            m_tile_energy[ty * m_tiles_x + tx] = (float)energy_sums[ty * m_tiles_x + tx] / pixels;
+        }
+    }
+}
+
+void frame_preprocessor_c::stretch(cv::Mat &luma)
+{
+    const int T = PREPROC_TILE_SIZE;
+    std::vector<uint8_t> lows(m_tiles_x * m_tiles_y);
+    std::vector<uint16_t> gains(m_tiles_x * m_tiles_y);
+
+    for (int ty = 0; ty < m_tiles_y; ++ty)
+    {
+        for (int tx = 0; tx < m_tiles_x; ++tx)
+        {
+            uint8_t lo = 0xFF;
+            uint8_t hi = 0;
+
+            for (int j = std::max(0, ty - 1); j <= std::min(m_tiles_y - 1, ty + 1); ++j)
+            {
+                for (int i = std::max(0, tx - 1); i <= std::min(m_tiles_x - 1, tx + 1); ++i)
+                {
+                    lo = std::min(lo, m_tile_min[j * m_tiles_x + i]);
+                    hi = std::max(hi, m_tile_max[j * m_tiles_x + i]);
+                }
+            }
+
+            bool is_flat = (hi <= lo || hi - lo < STRETCH_MIN_RANGE);
+
+            lows[ty * m_tiles_x + tx] = is_flat ? 0 : lo;
+            gains[ty * m_tiles_x + tx] = is_flat ? 256 : (uint16_t)(255 * 256 / (hi - lo));
+        }
+    }
+
+    for (int y = 0; y < luma.rows; ++y)
+    {
+        uint8_t *row = luma.ptr<uint8_t>(y);
+        int tile_base = (y / T) * m_tiles_x;
+
+        for (int tx = 0; tx < m_tiles_x; ++tx)
+        {
+            int x0 = tx * T;
+
+            row_stretch(row + x0, row + x0, std::min(T, luma.cols - x0), lows[tile_base + tx], gains[tile_base + tx]);
+        }
+    }
+}
+
+cv::Rect frame_preprocessor_c::find_roi(const cv::Mat &luma) const
+{
+    const int T = PREPROC_TILE_SIZE;
+    const cv::Rect whole(0, 0, luma.cols, luma.rows);
+    float max_energy = m_tile_energy.empty() ? 0 : *std::max_element(m_tile_energy.begin(), m_tile_energy.end());
+    int left = m_tiles_x;
+    int top = m_tiles_y;
+    int right = -1;
+    int bottom = -1;
+
+    if (max_energy < ROI_MIN_ENERGY)
+        return whole;
+
+    for (int ty = 0; ty < m_tiles_y; ++ty)
+    {
+        for (int tx = 0; tx < m_tiles_x; ++tx)
+        {
+            if (m_tile_energy[ty * m_tiles_x + tx] < max_energy * ROI_ENERGY_RATIO)
+                continue;
+
+            left = std::min(left, tx);
+            right = std::max(right, tx);
+            top = std::min(top, ty);
+            bottom = std::max(bottom, ty);
+        }
+    }
+
+    // One more tile around, in case the quiet zone or finder patterns are cut off.
+    left = std::max(0, left - 1);
+    top = std::max(0, top - 1);
+    right = std::min(m_tiles_x - 1, right + 1);
+    bottom = std::min(m_tiles_y - 1, bottom + 1);
+
+    cv::Rect roi = cv::Rect(left * T, top * T, (right - left + 1) * T, (bottom - top + 1) * T) & whole;
+
+    return (roi.area() > whole.area() * ROI_MAX_AREA_RATIO) ? whole : roi;
+}
+
+cv::Rect frame_preprocessor_c::apply(const cv::Mat &frame, cv::Mat &luma)
+{
+    if (1 == frame.channels())
+    {
+        if (MODE_NONE == m_mode)
+            luma = frame;
+        else
+            frame.copyTo(luma);
+    }
+    else
+        cv::cvtColor(frame, luma, cv::COLOR_BGR2GRAY);
+
+    if (MODE_STRETCH == m_mode || m_roi_assist)
+        compute_tile_stats(luma);
+
+    if (MODE_STRETCH == m_mode)
+        stretch(luma);
+    else if (MODE_CLAHE == m_mode)
+        m_clahe->apply(luma.clone(), luma);
+    else
+    {
+        // Nothing to enhance.
+    }
+
+    return m_roi_assist ? find_roi(luma) : cv::Rect(0, 0, luma.cols, luma.rows);
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ */
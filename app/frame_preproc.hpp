@@ -0,0 +1,90 @@
+/*
+ * Preprocessing of frames before barcode detection.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __FRAME_PREPROC_HPP__
+#define __FRAME_PREPROC_HPP__
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <opencv2/core/mat.hpp>
+#include <opencv2/imgproc.hpp>
+
+/*
+ * Mode is one of "none", "stretch" and "clahe".
+ * Works on luma only, in tiles of PREPROC_TILE_SIZE x PREPROC_TILE_SIZE pixels:
+ *   1) "stretch" maps each tile linearly from its local [min, max] (widened by neighbour tiles
+ *      to avoid visible seams) to [0, 255], which helps the binarizer of ZXing on low-contrast
+ *      and glare-affected frames;
+ *   2) "clahe" uses the CLAHE of OpenCV, which is more robust but slower;
+ *   3) ROI assist sums up horizontal and vertical gradient energy of each tile,
+ *      and returns the bounding box of tiles with outstanding energy (where barcodes probably are),
+ *      so that the decoder scans a smaller region first.
+ * Hot loops are vectorized with SSE2 on x86 and NEON on ARM, with a scalar fallback elsewhere.
+ */
+class frame_preprocessor_c
+{
+public:
+    frame_preprocessor_c(const std::string &mode, bool roi_assist);
+
+public:
+    bool enabled(void) const
+    {
+        return m_mode != MODE_NONE || m_roi_assist;
+    }
+
+    // Returns the region of interest in luma, which is the whole image if ROI assist is disabled or nothing stands out.
+    cv::Rect apply(const cv::Mat &frame, cv::Mat &luma);
+
+    static const char* simd_name(void);
+
+private:
+    void compute_tile_stats(const cv::Mat &luma);
+
+    void stretch(cv::Mat &luma);
+
+    cv::Rect find_roi(const cv::Mat &luma) const;
+
+private:
+    enum
+    {
+        MODE_NONE,
+        MODE_STRETCH,
+        MODE_CLAHE,
+    } m_mode;
+    bool m_roi_assist;
+    int m_tiles_x;
+    int m_tiles_y;
+    std::vector<uint8_t> m_tile_min;
+    std::vector<uint8_t> m_tile_max;
+    std::vector<float> m_tile_energy; // average gradient magnitude per pixel
+    cv::Ptr<cv::CLAHE> m_clahe;
+};
+
+#endif /* #ifndef __FRAME_PREPROC_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ */
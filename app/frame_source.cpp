@@ -0,0 +1,601 @@
+/*
+ * Sources of frames, and recording of them.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "frame_source.hpp"
+
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <mutex>
+#include <algorithm>
+
+#include "raw_frame.hpp"
+#include "shm_ring.hpp"
+
+#define RECORD_PAYLOAD_ALIGNMENT        8
+#define RECORD_BUFFER_SIZE              (4 * 1024 * 1024)
+#define SHM_FRAME_TIMEOUT_MS            10000 // same as select() timeout of V4L2 backend of OpenCV
+#define PIPE_FRAME_BUFFERS              4 // enough for capture, hand-off, decoding and displaying
+#define PIPE_SIZE_MAX                   (1024 * 1024) // default of /proc/sys/fs/pipe-max-size
+#define CAMERA_TIMESTAMP_AGE_MAX_MS     10000 // older timestamps can't be of monotonic clock
+
+static_assert(64 == sizeof(frame_record_header_t), "Size of frame_record_header_t must be 64");
+static_assert(32 == sizeof(frame_record_chunk_t), "Size of frame_record_chunk_t must be 32");
+
+static int64_t monotonic_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+int64_t camera_source_c::timestamp_ns(void) const
+{
+    // V4L2 drivers stamp buffers with monotonic clock mostly, while positions of files start from 0.
+    double pos_ms = m_vicap.get(cv::CAP_PROP_POS_MSEC);
+    int64_t age_ns = monotonic_ns() - (int64_t)(pos_ms * 1000000);
+
+    return (pos_ms > 0 && age_ns >= 0 && age_ns <= (int64_t)CAMERA_TIMESTAMP_AGE_MAX_MS * 1000000)
+        ? (int64_t)(pos_ms * 1000000) : 0;
+}
+
+frame_recorder_c::frame_recorder_c()
+    : m_stream(nullptr)
+    , m_buffer(nullptr)
+    , m_frame_count(0)
+{
+}
+
+frame_recorder_c::~frame_recorder_c()
+{
+    close();
+}
+
+int frame_recorder_c::open(const std::string &path, float fps)
+{
+    frame_record_header_t header = {};
+
+    if (nullptr == (m_stream = fopen(path.c_str(), "wbe")))
+    {
+        int err = errno;
+
+        fprintf(stderr, "*** Failed to create recording file %s: %s\n", path.c_str(), strerror(err));
+        return -err;
+    }
+
+    // Write-back is left to kernel as much as possible, so that the frame loop rarely blocks on disk.
+    m_buffer = new char[RECORD_BUFFER_SIZE];
+    setvbuf(m_stream, m_buffer, _IOFBF, RECORD_BUFFER_SIZE);
+
+    memcpy(header.magic, FRAME_RECORD_MAGIC, sizeof(header.magic));
+    header.header_size = sizeof(frame_record_header_t);
+    header.chunk_header_size = sizeof(frame_record_chunk_t);
+    header.fps = fps;
+    if (1 != fwrite(&header, sizeof(header), 1, m_stream))
+    {
+        int err = errno;
+
+        fprintf(stderr, "*** Failed to write recording file %s: %s\n", path.c_str(), strerror(err));
+        close();
+        return -err;
+    }
+    m_frame_count = 0;
+
+    return 0;
+}
+
+void frame_recorder_c::close(void)
+{
+    if (nullptr != m_stream)
+    {
+        fclose(m_stream);
+        m_stream = nullptr;
+    }
+
+    delete[] m_buffer;
+    m_buffer = nullptr;
+}
+
+int frame_recorder_c::write(const cv::Mat &frame, int64_t timestamp_ns)
+{
+    static const uint8_t PADDING[RECORD_PAYLOAD_ALIGNMENT] = {};
+    frame_record_chunk_t chunk = {};
+    size_t row_size = frame.cols * frame.elemSize();
+    size_t data_size = row_size * frame.rows;
+    size_t padding = (RECORD_PAYLOAD_ALIGNMENT - data_size % RECORD_PAYLOAD_ALIGNMENT) % RECORD_PAYLOAD_ALIGNMENT;
+
+    memcpy(chunk.magic, FRAME_CHUNK_MAGIC, sizeof(chunk.magic));
+    chunk.payload_size = data_size + padding;
+    chunk.timestamp_ns = (timestamp_ns > 0) ? timestamp_ns : monotonic_ns();
+    chunk.width = frame.cols;
+    chunk.height = frame.rows;
+    chunk.type = frame.type();
+    chunk.step = row_size; // rows are packed in file
+
+    if (1 != fwrite(&chunk, sizeof(chunk), 1, m_stream))
+        return -EIO;
+
+    for (int i = 0; i < frame.rows; ++i)
+    {
+        if (1 != fwrite(frame.ptr(i), row_size, 1, m_stream))
+            return -EIO;
+    }
+
+    if (padding > 0 && 1 != fwrite(PADDING, padding, 1, m_stream))
+        return -EIO;
+
+    ++m_frame_count;
+
+    return 0;
+}
+
+replay_source_c::replay_source_c(float speed)
+    : m_speed(speed)
+    , m_addr(nullptr)
+    , m_size(0)
+    , m_offset(0)
+    , m_first_timestamp_ns(-1)
+    , m_start_ns(0)
+    , m_timestamp_ns(0)
+{
+}
+
+replay_source_c::~replay_source_c()
+{
+    release();
+}
+
+int replay_source_c::open(const std::string &path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    int err;
+
+    if (fd < 0)
+    {
+        err = -errno;
+        goto lbl_err;
+    }
+
+    if (fstat(fd, &st) < 0)
+    {
+        err = -errno;
+        goto lbl_close_fd;
+    }
+
+    if (st.st_size < (off_t)sizeof(frame_record_header_t))
+    {
+        err = -EINVAL;
+        goto lbl_close_fd;
+    }
+
+    // Private and writable, so that marks drawn on frames by GUI go to copy-on-write pages instead of the file.
+    m_addr = (uint8_t *)mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED == m_addr)
+    {
+        m_addr = nullptr;
+        err = -errno;
+        goto lbl_close_fd;
+    }
+    ::close(fd);
+    m_size = st.st_size;
+    madvise(m_addr, m_size, MADV_SEQUENTIAL);
+
+    {
+        const frame_record_header_t *header = (const frame_record_header_t *)m_addr;
+
+        // Chunks begin where the header ends, and must stay 8-aligned for the pixels within.
+        if (0 != memcmp(header->magic, FRAME_RECORD_MAGIC, strlen(FRAME_RECORD_MAGIC))
+            || header->header_size < sizeof(frame_record_header_t) || 0 != header->header_size % 8
+            || header->header_size > m_size || sizeof(frame_record_chunk_t) != header->chunk_header_size)
+        {
+            release();
+            err = -EINVAL;
+            goto lbl_err;
+        }
+        m_offset = header->header_size;
+    }
+
+    return 0;
+
+lbl_close_fd:
+    ::close(fd);
+
+lbl_err:
+    fprintf(stderr, "*** Failed to open recording file %s: %s\n", path.c_str(), strerror(-err));
+
+    return err;
+}
+
+const frame_record_chunk_t* replay_source_c::next_chunk(void)
+{
+    const frame_record_chunk_t *chunk;
+
+    if (nullptr == m_addr || m_offset + sizeof(frame_record_chunk_t) > m_size)
+        return nullptr;
+
+    chunk = (const frame_record_chunk_t *)(m_addr + m_offset);
+    if (0 != memcmp(chunk->magic, FRAME_CHUNK_MAGIC, sizeof(chunk->magic))
+        || m_offset + sizeof(frame_record_chunk_t) + chunk->payload_size > m_size
+        || 0 == chunk->width || 0 == chunk->height
+        // Only 8-bit pixels of 1 to 4 channels are ever recorded.
+        || chunk->type != (uint32_t)CV_MAKETYPE(CV_8U, CV_MAT_CN(chunk->type)) || CV_MAT_CN(chunk->type) > 4
+        || (size_t)chunk->width * CV_ELEM_SIZE(chunk->type) > chunk->step
+        || (size_t)chunk->step * chunk->height > chunk->payload_size)
+    {
+        fprintf(stderr, "*** Recording file is truncated or corrupted at offset %zu\n", m_offset);
+        m_offset = m_size;
+        return nullptr;
+    }
+    m_offset += sizeof(frame_record_chunk_t) + chunk->payload_size;
+
+    if (m_speed <= 0)
+    {
+        m_timestamp_ns = 0;
+        return chunk;
+    }
+
+    if (m_first_timestamp_ns < 0)
+    {
+        m_first_timestamp_ns = chunk->timestamp_ns;
+        m_start_ns = monotonic_ns();
+    }
+
+    // Sleep until the moment this frame was captured, relative to the first one.
+    int64_t due_ns = m_start_ns + (int64_t)((chunk->timestamp_ns - m_first_timestamp_ns) / m_speed);
+    int64_t wait_ns = due_ns - monotonic_ns();
+
+    m_timestamp_ns = due_ns;
+
+    if (wait_ns > 0)
+    {
+        struct timespec ts = { (time_t)(wait_ns / 1000000000), (long)(wait_ns % 1000000000) };
+
+        nanosleep(&ts, nullptr);
+    }
+
+    return chunk;
+}
+
+bool replay_source_c::grab(void)
+{
+    return nullptr != next_chunk();
+}
+
+bool replay_source_c::read(cv::Mat &frame)
+{
+    const frame_record_chunk_t *chunk = next_chunk();
+
+    if (nullptr == chunk)
+        return false;
+
+    frame = cv::Mat(chunk->height, chunk->width, chunk->type, (void *)(chunk + 1), chunk->step);
+
+    return true;
+}
+
+double replay_source_c::get_fps(void) const
+{
+    return (nullptr == m_addr) ? 0 : ((const frame_record_header_t *)m_addr)->fps;
+}
+
+void replay_source_c::release(void)
+{
+    if (nullptr != m_addr)
+    {
+        munmap(m_addr, m_size);
+        m_addr = nullptr;
+    }
+    m_size = 0;
+    m_offset = 0;
+}
+
+/*
+ * Matrices are created with this allocator over a claimed slot, so that the slot is unclaimed
+ * once the last reference to the matrix is gone, on whichever thread that happens.
+ */
+class shm_frame_allocator_c : public cv::MatAllocator
+{
+public:
+    shm_frame_allocator_c()
+        : m_pending(nullptr)
+        , m_outstanding(0)
+        , m_closing(false)
+    {
+    }
+
+public:
+    shm_ring_c& ring(void)
+    {
+        return m_ring;
+    }
+
+    // Creates a matrix over the pixels of a claimed slot.
+    void wrap(shm_slot_header_t *slot, cv::Mat &frame)
+    {
+        frame.release(); // which may call deallocate()
+
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        frame.allocator = this;
+        m_pending = slot;
+        ++m_outstanding;
+        frame.create(slot->height, slot->width, raw_frame_mat_type(slot->format));
+        frame.allocator = nullptr; // so that nothing else is allocated by it
+    }
+
+    // Closes the ring now, or once the last outstanding frame is released.
+    void close(void)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        m_closing = true;
+        if (0 == m_outstanding)
+            m_ring.close();
+    }
+
+    cv::UMatData* allocate(int dims, const int *sizes, int type, void *data, size_t *step,
+        cv::AccessFlag flags, cv::UMatUsageFlags usage_flags) const override
+    {
+        // Called within wrap() with the lock held.
+        shm_slot_header_t *slot = m_pending;
+        cv::UMatData *u = new cv::UMatData(this);
+
+        CV_Assert(nullptr != slot && 2 == dims && nullptr == data);
+        step[0] = slot->stride;
+        step[1] = CV_ELEM_SIZE(type);
+        u->data = u->origdata = shm_ring_c::pixels_of(slot);
+        u->size = (size_t)slot->stride * slot->height;
+        u->userdata = slot;
+        m_pending = nullptr;
+
+        return u;
+    }
+
+    bool allocate(cv::UMatData *data, cv::AccessFlag access_flags, cv::UMatUsageFlags usage_flags) const override
+    {
+        return false;
+    }
+
+    void deallocate(cv::UMatData *data) const override
+    {
+        if (nullptr == data)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        m_ring.unclaim((shm_slot_header_t *)data->userdata);
+        if (0 == --m_outstanding && m_closing)
+            m_ring.close();
+        delete data;
+    }
+
+private:
+    mutable std::mutex m_lock;
+    mutable shm_ring_c m_ring;
+    mutable shm_slot_header_t *m_pending;
+    mutable int m_outstanding;
+    bool m_closing;
+};
+
+shm_source_c::shm_source_c()
+    : m_allocator(new shm_frame_allocator_c())
+    , m_timestamp_ns(0)
+{
+}
+
+shm_source_c::~shm_source_c()
+{
+    release();
+}
+
+int shm_source_c::open(const std::string &name)
+{
+    return m_allocator->ring().attach(name);
+}
+
+bool shm_source_c::grab(void)
+{
+    shm_ring_c &ring = m_allocator->ring();
+    shm_slot_header_t *slot = ring.is_open() ? ring.claim_latest(SHM_FRAME_TIMEOUT_MS) : nullptr;
+
+    if (nullptr == slot)
+        return false;
+
+    ring.unclaim(slot);
+
+    return true;
+}
+
+bool shm_source_c::read(cv::Mat &frame)
+{
+    shm_ring_c &ring = m_allocator->ring();
+    shm_slot_header_t *slot = ring.is_open() ? ring.claim_latest(SHM_FRAME_TIMEOUT_MS) : nullptr;
+
+    if (nullptr == slot)
+        return false;
+
+    m_timestamp_ns = slot->timestamp_ns;
+    m_allocator->wrap(slot, frame);
+
+    return true;
+}
+
+double shm_source_c::get_fps(void) const
+{
+    const shm_ring_header_t *header = m_allocator->ring().header();
+
+    return (nullptr == header) ? 0 : header->fps;
+}
+
+void shm_source_c::release(void)
+{
+    m_allocator->close();
+}
+
+pipe_source_c::pipe_source_c(uint32_t format, int width, int height, float fps)
+    : m_format(format)
+    , m_width(width)
+    , m_height(height)
+    , m_fps(fps)
+    , m_frame_size(raw_frame_size(format, width, height, raw_frame_min_stride(format, width)))
+    , m_fd(-1)
+    , m_eof(false)
+{
+}
+
+pipe_source_c::~pipe_source_c()
+{
+    release();
+}
+
+int pipe_source_c::open(const std::string &path)
+{
+    bool is_stdin = (path.empty() || "-" == path);
+    int err;
+
+    if (0 == m_frame_size)
+    {
+        err = -EINVAL;
+        goto lbl_err;
+    }
+
+    if ((m_fd = is_stdin ? STDIN_FILENO : ::open(path.c_str(), O_RDONLY | O_CLOEXEC)) < 0)
+    {
+        err = -errno;
+        goto lbl_err;
+    }
+
+    // The default pipe of 64KB would take dozens of context switches per frame. Not fatal if refused.
+    fcntl(m_fd, F_SETPIPE_SZ, (int)std::min(m_frame_size, (size_t)PIPE_SIZE_MAX));
+    fprintf(stderr, "Reading %dx%d %s frames of %zu bytes from %s\n", m_width, m_height, raw_format_name(m_format),
+        m_frame_size, is_stdin ? "stdin" : path.c_str());
+
+    return 0;
+
+lbl_err:
+    fprintf(stderr, "*** Failed to open %s for raw frames: %s\n", is_stdin ? "stdin" : path.c_str(), strerror(-err));
+
+    return err;
+}
+
+cv::Mat& pipe_source_c::vacant_buffer(void)
+{
+    for (cv::Mat &buffer : m_buffers)
+    {
+        if (1 == CV_XADD(&buffer.u->refcount, 0)) // referred to by nobody else
+            return buffer;
+    }
+
+    // Planes are stacked in rows, with the minimum stride.
+    int rows = m_frame_size / raw_frame_min_stride(m_format, m_width);
+
+    if (m_buffers.size() < PIPE_FRAME_BUFFERS)
+    {
+        m_buffers.emplace_back(rows, m_width, raw_frame_mat_type(m_format));
+        return m_buffers.back();
+    }
+
+    // All taken, which is unlikely: replace the oldest one, leaving it to its holders.
+    m_buffers.front() = cv::Mat(rows, m_width, raw_frame_mat_type(m_format));
+
+    return m_buffers.front();
+}
+
+bool pipe_source_c::fill(cv::Mat &buffer)
+{
+    uint8_t *ptr = buffer.data;
+    size_t remaining = m_frame_size;
+
+    if (m_fd < 0 || m_eof)
+        return false;
+
+    // Each read() takes as much as the pipe holds, straight into the frame.
+    while (remaining > 0)
+    {
+        ssize_t bytes = ::read(m_fd, ptr, remaining);
+
+        if (bytes > 0)
+        {
+            ptr += bytes;
+            remaining -= bytes;
+        }
+        else if (0 == bytes)
+        {
+            if (remaining < m_frame_size)
+                fprintf(stderr, "*** Last frame is truncated, %zu of %zu bytes\n", m_frame_size - remaining, m_frame_size);
+            m_eof = true;
+            return false;
+        }
+        else if (EINTR != errno)
+        {
+            fprintf(stderr, "*** Failed to read raw frame: %s\n", strerror(errno));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool pipe_source_c::grab(void)
+{
+    return fill(vacant_buffer());
+}
+
+bool pipe_source_c::read(cv::Mat &frame)
+{
+    frame.release(); // so that its buffer can be refilled
+
+    cv::Mat &buffer = vacant_buffer();
+
+    if (!fill(buffer))
+        return false;
+
+    frame = (RAW_FORMAT_NV12 == m_format) ? buffer.rowRange(0, m_height) : buffer;
+
+    return true;
+}
+
+void pipe_source_c::release(void)
+{
+    if (m_fd > STDIN_FILENO)
+        ::close(m_fd);
+    m_fd = -1;
+    m_buffers.clear(); // frames still referred to by others are freed by them
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Add shm_source_c.
+ *  03. Add pipe_source_c.
+ *  04. Add timestamp_ns() of sources.
+ *  05. Validate headers of recording files and fields of chunks before use.
+ *  06. Stamp recorded chunks with capture time of frames instead of time of writing.
+ */
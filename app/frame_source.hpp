@@ -0,0 +1,380 @@
+/*
+ * Sources of frames, and recording of them.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __FRAME_SOURCE_HPP__
+#define __FRAME_SOURCE_HPP__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <functional>
+
+#include <opencv2/core/mat.hpp>
+#include <opencv2/videoio.hpp>
+
+/*
+ * Interface of the frame loop, which behaves like cv::VideoCapture.
+ */
+class frame_source_c
+{
+public:
+    virtual ~frame_source_c()
+    {
+    }
+
+public:
+    // Dequeues a frame without retrieving it.
+    virtual bool grab(void) = 0;
+
+    // Frame may refer to memory owned by the source, and stays valid until the source is released.
+    virtual bool read(cv::Mat &frame) = 0;
+
+    virtual bool set_fps(float fps) = 0;
+
+    virtual double get_fps(void) const = 0;
+
+    virtual void release(void) = 0;
+
+    // True if reading fails because there're no more frames, rather than an error.
+    virtual bool exhausted(void) const
+    {
+        return false;
+    }
+
+    // True if frames come in real time, and are better dropped than waited for when consumers lag behind.
+    virtual bool live(void) const
+    {
+        return true;
+    }
+
+    // Capture time of the frame last read, in nanoseconds of monotonic clock (the one of std::chrono::steady_clock),
+    // or 0 if unknown, in which case the moment reading returns is the closest.
+    virtual int64_t timestamp_ns(void) const
+    {
+        return 0;
+    }
+
+    // Releases the source and opens it again in place, to recover from failures.
+    // Returns 0, or -ENOTSUP if the source can't be reopened, or another negative error code.
+    virtual int reopen(void)
+    {
+        return -ENOTSUP;
+    }
+};
+
+class camera_source_c : public frame_source_c
+{
+public:
+    // Opener opens the capture with all properties set, and returns 0 or a negative error code.
+    camera_source_c(const std::function<int(cv::VideoCapture &)> &opener)
+        : m_opener(opener)
+    {
+    }
+
+public:
+    int open(void)
+    {
+        return m_opener(m_vicap);
+    }
+
+    int reopen(void) override
+    {
+        m_vicap.release();
+
+        return m_opener(m_vicap);
+    }
+
+    bool grab(void) override
+    {
+        return m_vicap.grab();
+    }
+
+    bool read(cv::Mat &frame) override
+    {
+        return m_vicap.read(frame);
+    }
+
+    bool set_fps(float fps) override
+    {
+        return m_vicap.set(cv::CAP_PROP_FPS, fps);
+    }
+
+    double get_fps(void) const override
+    {
+        return m_vicap.get(cv::CAP_PROP_FPS);
+    }
+
+    void release(void) override
+    {
+        m_vicap.release();
+    }
+
+    // Timestamp of driver buffer (CAP_PROP_POS_MSEC of V4L2 backend), if it's of monotonic clock.
+    // Positions in media of files and streams are not.
+    int64_t timestamp_ns(void) const override;
+
+private:
+    const std::function<int(cv::VideoCapture &)> m_opener;
+    cv::VideoCapture m_vicap;
+};
+
+/*
+ * Layout of a recording file (in native byte order):
+ *   1) a file header of 64 bytes, see frame_record_header_t;
+ *   2) followed by chunks, each of which is a chunk header of 32 bytes (see frame_record_chunk_t)
+ *      and pixels of a frame padded to a multiple of 8 bytes.
+ * Frames are stored as captured, without any compression, so that replaying costs nothing but page faults.
+ */
+#define FRAME_RECORD_MAGIC              "BCSREC01"
+#define FRAME_CHUNK_MAGIC               "FRAM"
+
+typedef struct frame_record_header
+{
+    char magic[8];
+    uint32_t header_size;
+    uint32_t chunk_header_size;
+    float fps; // requested when recording
+    uint8_t reserved[44];
+} frame_record_header_t;
+
+typedef struct frame_record_chunk
+{
+    char magic[4];
+    uint32_t payload_size; // including padding
+    uint64_t timestamp_ns; // of monotonic clock
+    uint16_t width;
+    uint16_t height;
+    uint32_t type; // of cv::Mat
+    uint32_t step;
+    uint32_t reserved;
+} frame_record_chunk_t;
+
+class frame_recorder_c
+{
+public:
+    frame_recorder_c();
+
+    ~frame_recorder_c();
+
+public:
+    int open(const std::string &path, float fps);
+
+    void close(void);
+
+    bool is_open(void) const
+    {
+        return nullptr != m_stream;
+    }
+
+    // Timestamp is the capture time of frame in nanoseconds of monotonic clock, or 0 for the time of writing,
+    // so that replays are paced (and measured) as frames were captured rather than written.
+    int write(const cv::Mat &frame, int64_t timestamp_ns);
+
+    uint64_t frame_count(void) const
+    {
+        return m_frame_count;
+    }
+
+private:
+    FILE *m_stream;
+    char *m_buffer;
+    uint64_t m_frame_count;
+};
+
+/*
+ * Frames are handed out as headers of Mat pointing into the memory-mapped file, without copying.
+ * With a positive speed, frames are paced by their recorded timestamps (2 means twice as fast),
+ * while 0 means as fast as possible. Reading fails at the end of file, as a camera being unplugged.
+ */
+class replay_source_c : public frame_source_c
+{
+public:
+    replay_source_c(float speed);
+
+    ~replay_source_c();
+
+public:
+    int open(const std::string &path);
+
+    bool grab(void) override;
+
+    bool read(cv::Mat &frame) override;
+
+    // Pacing follows the recording, so FPS is not adjustable.
+    bool set_fps(float fps) override
+    {
+        return false;
+    }
+
+    double get_fps(void) const override;
+
+    void release(void) override;
+
+    bool exhausted(void) const override
+    {
+        return m_offset >= m_size;
+    }
+
+    // Every frame is decoded even at full speed, so that replaying is reproducible.
+    bool live(void) const override
+    {
+        return false;
+    }
+
+    // The moment the frame is due by pacing, 0 at full speed.
+    int64_t timestamp_ns(void) const override
+    {
+        return m_timestamp_ns;
+    }
+
+private:
+    const frame_record_chunk_t* next_chunk(void);
+
+private:
+    const float m_speed;
+    uint8_t *m_addr;
+    size_t m_size;
+    size_t m_offset;
+    int64_t m_first_timestamp_ns;
+    int64_t m_start_ns;
+    int64_t m_timestamp_ns;
+};
+
+class shm_ring_c;
+class shm_frame_allocator_c;
+
+/*
+ * Frames are handed out as matrices over slots of a shared-memory ring (see shm_ring.hpp) without copying,
+ * and each slot is held against overwriting by producer until the last matrix referring to it is released.
+ * Only the latest frame is read, and older ones not read yet are skipped.
+ * NV12 frames are handed out as their luma planes, which is all that decoding needs.
+ * Like other sources, it must outlive the frames handed out.
+ */
+class shm_source_c : public frame_source_c
+{
+public:
+    shm_source_c();
+
+    ~shm_source_c();
+
+public:
+    int open(const std::string &name);
+
+    bool grab(void) override;
+
+    bool read(cv::Mat &frame) override;
+
+    // Pacing is up to the producer.
+    bool set_fps(float fps) override
+    {
+        return false;
+    }
+
+    double get_fps(void) const override;
+
+    // Mapping is kept until all frames handed out are released.
+    void release(void) override;
+
+    // Stamped by producer when publishing.
+    int64_t timestamp_ns(void) const override
+    {
+        return m_timestamp_ns;
+    }
+
+private:
+    std::unique_ptr<shm_frame_allocator_c> m_allocator;
+    int64_t m_timestamp_ns;
+};
+
+/*
+ * Frames of fixed size and pixel format (see raw_frame.hpp) are read back to back from a pipe,
+ * such as stdout of ffmpeg with -f rawvideo, straight into a few reusable buffers.
+ * A buffer is refilled only when no frame handed out refers to it any more.
+ * NV12 frames are handed out as their luma planes, which is all that decoding needs.
+ * Reading fails at the end of stream, or on a truncated frame.
+ */
+class pipe_source_c : public frame_source_c
+{
+public:
+    pipe_source_c(uint32_t format, int width, int height, float fps);
+
+    ~pipe_source_c();
+
+public:
+    // Empty path or "-" means stdin, otherwise a FIFO or file.
+    int open(const std::string &path);
+
+    bool grab(void) override;
+
+    bool read(cv::Mat &frame) override;
+
+    // Pacing is up to the writer.
+    bool set_fps(float fps) override
+    {
+        return false;
+    }
+
+    // Nominal, as specified.
+    double get_fps(void) const override
+    {
+        return m_fps;
+    }
+
+    void release(void) override;
+
+    bool exhausted(void) const override
+    {
+        return m_eof;
+    }
+
+private:
+    cv::Mat& vacant_buffer(void);
+
+    bool fill(cv::Mat &buffer);
+
+private:
+    const uint32_t m_format;
+    const int m_width;
+    const int m_height;
+    const float m_fps;
+    const size_t m_frame_size;
+    int m_fd;
+    bool m_eof;
+    std::vector<cv::Mat> m_buffers;
+};
+
+#endif /* #ifndef __FRAME_SOURCE_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Add frame_source_c::live().
+ *  03. Add shm_source_c.
+ *  04. Add pipe_source_c.
+ *  05. Add frame_source_c::reopen().
+ *  06. Add frame_source_c::timestamp_ns().
+ *  07. Stamp recorded chunks with capture time of frames.
+ */
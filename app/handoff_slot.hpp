@@ -0,0 +1,124 @@
+/*
+ * Single-slot handoff of items between two threads.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __HANDOFF_SLOT_HPP__
+#define __HANDOFF_SLOT_HPP__
+
+#include <mutex>
+#include <chrono>
+#include <utility>
+#include <condition_variable>
+
+/*
+ * In lossy mode, a new item replaces the one not taken yet, so that the consumer always gets the latest
+ * and never lags behind a live producer. In lossless mode, the producer waits until the slot is free.
+ * Once closed, producers are refused, while the item left in the slot can still be taken.
+ */
+template<typename T>
+class handoff_slot_c
+{
+public:
+    handoff_slot_c(bool lossless)
+        : m_lossless(lossless)
+        , m_full(false)
+        , m_closed(false)
+    {
+    }
+
+public:
+    // Returns the number of items replaced (0 or 1), or -1 if closed.
+    int put(T &&item)
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        int replaced;
+
+        if (m_lossless)
+            m_cond.wait(lock, [this] { return !m_full || m_closed; });
+
+        if (m_closed)
+            return -1;
+
+        replaced = m_full ? 1 : 0;
+        m_item = std::move(item);
+        m_full = true;
+        lock.unlock();
+        m_cond.notify_all();
+
+        return replaced;
+    }
+
+    // Waits for an item for at most timeout_ms (forever if negative).
+    // Returns false on timeout, or if closed and empty.
+    bool take(T &item, int timeout_ms = -1)
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        auto ready = [this] { return m_full || m_closed; };
+
+        if (timeout_ms < 0)
+            m_cond.wait(lock, ready);
+        else if (!m_cond.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready))
+            return false;
+
+        if (!m_full)
+            return false;
+
+        item = std::move(m_item);
+        m_item = T();
+        m_full = false;
+        lock.unlock();
+        m_cond.notify_all();
+
+        return true;
+    }
+
+    // True if an item is waiting to be taken, which supersedes the last one taken in lossy mode.
+    bool pending(void)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        return m_full;
+    }
+
+    void close(void)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        m_closed = true;
+        m_cond.notify_all();
+    }
+
+private:
+    const bool m_lossless;
+    bool m_full;
+    bool m_closed;
+    T m_item;
+    std::mutex m_lock;
+    std::condition_variable m_cond;
+};
+
+#endif /* #ifndef __HANDOFF_SLOT_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Add pending().
+ */
@@ -0,0 +1,359 @@
+/*
+ * Streamed list of image files from command line, manifest files and directories.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "image_list.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "shard_results.hpp"
+#include "archive_reader.hpp"
+
+static bool has_image_suffix(const char *name)
+{
+    static const char *SUFFIXES[] = {
+        ".jpg", ".jpeg", ".jpe", ".png", ".bmp", ".dib", ".tif", ".tiff", ".webp",
+        ".pbm", ".pgm", ".ppm", ".pxm", ".pnm", ".jp2", ".sr", ".ras", ".hdr", ".pic",
+    };
+    const char *dot = strrchr(name, '.');
+
+    if (nullptr == dot)
+        return false;
+
+    for (const char *suffix : SUFFIXES)
+    {
+        if (0 == strcasecmp(dot, suffix))
+            return true;
+    }
+
+    return false;
+}
+
+static bool is_directory(const std::string &path)
+{
+    struct stat st;
+
+    return 0 == stat(path.c_str(), &st) && S_ISDIR(st.st_mode);
+}
+
+image_list_c::image_list_c(const std::vector<std::string> &items, const std::string &manifest, size_t prefetch_depth)
+    : m_items(items)
+    , m_item_index(0)
+    , m_prefetch_depth((prefetch_depth > 0) ? prefetch_depth : 1)
+    , m_is_batch(!manifest.empty() || items.size() > 1 || (1 == items.size() && is_directory(items[0])))
+    , m_is_valid(true)
+    , m_shard_index(0)
+    , m_shard_count(1)
+    , m_manifest_stream(nullptr)
+    , m_manifest_map(nullptr)
+    , m_manifest_size(0)
+    , m_manifest_offset(0)
+    , m_line_buf(nullptr)
+    , m_line_cap(0)
+{
+    if (!manifest.empty() && open_manifest(manifest) < 0)
+        m_is_valid = false;
+}
+
+image_list_c::~image_list_c()
+{
+    for (auto &frame : m_dir_stack)
+    {
+        closedir(frame.dir);
+    }
+    m_dir_stack.clear();
+
+    close_manifest();
+    free(m_line_buf);
+}
+
+int image_list_c::open_manifest(const std::string &path)
+{
+    if ("-" == path)
+    {
+        m_manifest_stream = stdin;
+        return 0;
+    }
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+
+    if (fd < 0)
+    {
+        int err = errno;
+
+        fprintf(stderr, "*** Failed to open manifest file %s: %s\n", path.c_str(), strerror(err));
+        return -err;
+    }
+
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode) || 0 == st.st_size)
+        goto lbl_stream;
+
+    m_manifest_map = (const char *)mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED == (void *)m_manifest_map)
+    {
+        m_manifest_map = nullptr;
+        goto lbl_stream;
+    }
+    m_manifest_size = st.st_size;
+    // Pages already parsed can be dropped early.
+    madvise((void *)m_manifest_map, m_manifest_size, MADV_SEQUENTIAL);
+    close(fd);
+
+    return 0;
+
+lbl_stream:
+    // Pipes, character devices and so on can not be mapped.
+    if (nullptr == (m_manifest_stream = fdopen(fd, "r")))
+    {
+        int err = errno;
+
+        fprintf(stderr, "*** Failed to read manifest file %s: %s\n", path.c_str(), strerror(err));
+        close(fd);
+        return -err;
+    }
+
+    return 0;
+}
+
+void image_list_c::close_manifest(void)
+{
+    if (nullptr != m_manifest_map)
+    {
+        munmap((void *)m_manifest_map, m_manifest_size);
+        m_manifest_map = nullptr;
+    }
+
+    if (nullptr != m_manifest_stream)
+    {
+        if (stdin != m_manifest_stream)
+            fclose(m_manifest_stream);
+        m_manifest_stream = nullptr;
+    }
+}
+
+// Assigns the trimmed line to path, or returns false if it should be ignored.
+static bool parse_manifest_line(const char *line, size_t len, std::string &path)
+{
+    while (len > 0 && strchr(" \t\r\n", line[len - 1]))
+    {
+        --len;
+    }
+
+    if (0 == len || '#' == line[0])
+        return false;
+
+    path.assign(line, len);
+
+    return true;
+}
+
+bool image_list_c::produce_from_manifest(std::string &path)
+{
+    if (nullptr != m_manifest_map)
+    {
+        while (m_manifest_offset < m_manifest_size)
+        {
+            const char *line = m_manifest_map + m_manifest_offset;
+            size_t rest = m_manifest_size - m_manifest_offset;
+            const char *newline = (const char *)memchr(line, '\n', rest);
+            size_t len = newline ? (size_t)(newline - line) : rest;
+
+            m_manifest_offset += len + (newline ? 1 : 0);
+            if (parse_manifest_line(line, len, path))
+                return true;
+        }
+
+        return false;
+    }
+
+    ssize_t len;
+
+    while (nullptr != m_manifest_stream && (len = getline(&m_line_buf, &m_line_cap, m_manifest_stream)) >= 0)
+    {
+        if (parse_manifest_line(m_line_buf, len, path))
+            return true;
+    }
+
+    return false;
+}
+
+bool image_list_c::produce_from_dirs(std::string &path)
+{
+    while (!m_dir_stack.empty())
+    {
+        struct dirent *entry = readdir(m_dir_stack.back().dir);
+
+        if (nullptr == entry)
+        {
+            closedir(m_dir_stack.back().dir);
+            m_dir_stack.pop_back();
+            continue;
+        }
+
+        const char *name = entry->d_name;
+
+        if ('.' == name[0] && ('\0' == name[1] || ('.' == name[1] && '\0' == name[2])))
+            continue;
+
+        std::string full_path = m_dir_stack.back().path + "/" + name;
+        unsigned char type = entry->d_type;
+
+        if (DT_UNKNOWN == type || DT_LNK == type)
+        {
+            struct stat st;
+
+            if (stat(full_path.c_str(), &st) < 0)
+                continue;
+
+            // Symbolic links to directories are not followed, in case of loops.
+            if (S_ISREG(st.st_mode))
+                type = DT_REG;
+            else if (S_ISDIR(st.st_mode) && DT_UNKNOWN == type)
+                type = DT_DIR;
+            else
+                continue;
+        }
+
+        if (DT_DIR == type)
+        {
+            DIR *dir = opendir(full_path.c_str());
+
+            if (nullptr == dir)
+                fprintf(stderr, "*** Failed to open directory %s: %s\n", full_path.c_str(), strerror(errno));
+            else
+                m_dir_stack.push_back({ dir, std::move(full_path) });
+        }
+        else if (DT_REG == type && has_image_suffix(name))
+        {
+            path = std::move(full_path);
+            return true;
+        }
+        else
+        {
+            // Ignore other files.
+        }
+    }
+
+    return false;
+}
+
+bool image_list_c::produce(std::string &path)
+{
+    while (true)
+    {
+        if (!m_dir_stack.empty() && produce_from_dirs(path))
+            return true;
+
+        if (m_item_index < m_items.size())
+        {
+            const std::string &item = m_items[m_item_index++];
+
+            if (!is_directory(item))
+            {
+                path = item;
+                return true;
+            }
+
+            size_t len = item.find_last_not_of('/');
+            std::string dir_path = (std::string::npos == len) ? "/" : item.substr(0, len + 1);
+            DIR *dir = opendir(dir_path.c_str());
+
+            if (nullptr == dir)
+                fprintf(stderr, "*** Failed to open directory %s: %s\n", dir_path.c_str(), strerror(errno));
+            else
+                m_dir_stack.push_back({ dir, (std::string::npos == len) ? "" : std::move(dir_path) });
+
+            continue;
+        }
+
+        if (produce_from_manifest(path))
+            return true;
+
+        close_manifest();
+
+        return false;
+    }
+}
+
+void image_list_c::prefetch(const std::string &path)
+{
+    // Archives may be huge and are read sequentially anyway, where readahead of kernel suffices.
+    if (archive_reader_c::is_archive_path(path))
+        return;
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC | O_NONBLOCK);
+
+    if (fd < 0)
+        return; // Leave the error to the decoder.
+
+    // Asynchronous read-ahead of the whole file into page cache.
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    close(fd);
+}
+
+bool image_list_c::fill_window(void)
+{
+    std::string path;
+
+    while (m_window.size() < m_prefetch_depth && produce(path))
+    {
+        if (shard_of_path(path, m_shard_count) != m_shard_index)
+            continue;
+
+        prefetch(path);
+        m_window.push_back(std::move(path));
+    }
+
+    return !m_window.empty();
+}
+
+bool image_list_c::next(std::string &path)
+{
+    if (!fill_window())
+        return false;
+
+    path = std::move(m_window.front());
+    m_window.pop_front();
+    fill_window();
+
+    return true;
+}
+
+bool image_list_c::empty(void)
+{
+    return !fill_window();
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Support sharding.
+ *  03. Skip prefetching of archives.
+ *  04. Tell failures of opening manifest through is_valid().
+ */
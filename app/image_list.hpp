@@ -0,0 +1,124 @@
+/*
+ * Streamed list of image files from command line, manifest files and directories.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __IMAGE_LIST_HPP__
+#define __IMAGE_LIST_HPP__
+
+#include <stdio.h>
+#include <dirent.h>
+
+#include <string>
+#include <vector>
+#include <deque>
+
+/*
+ * Paths are produced one by one instead of being collected beforehand,
+ * so that memory usage stays constant no matter how many images there are:
+ *   1) A manifest file contains one path per line (empty lines and lines beginning with # are ignored),
+ *      and is memory-mapped, or streamed if it's "-" (stdin) or not mappable.
+ *   2) A directory is walked recursively, and only files with known image suffixes are picked.
+ *   3) Anything else is treated as an image file.
+ * A small window of upcoming files is kept and their contents are hinted to the kernel for read-ahead,
+ * so that disk I/O overlaps with decoding.
+ * In a shard, paths of other shards are skipped before being read ahead (see shard_results.hpp).
+ */
+class image_list_c
+{
+public:
+    image_list_c(const std::vector<std::string> &items, const std::string &manifest, size_t prefetch_depth = 16);
+
+    ~image_list_c();
+
+public:
+    // False if the manifest fails to be opened, in which case nothing should be taken as an empty list.
+    bool is_valid(void) const
+    {
+        return m_is_valid;
+    }
+
+    // Returns false if all paths have been consumed.
+    bool next(std::string &path);
+
+    // Returns true if nothing is left after the path just returned by next().
+    bool empty(void);
+
+    // Called before the first next(). Index is 0-based.
+    void set_shard(int index, int count)
+    {
+        m_shard_index = index;
+        m_shard_count = count;
+    }
+
+    // Returns true if the list possibly contains more than one image.
+    bool is_batch(void) const
+    {
+        return m_is_batch;
+    }
+
+private:
+    bool fill_window(void);
+
+    bool produce(std::string &path);
+
+    bool produce_from_manifest(std::string &path);
+
+    bool produce_from_dirs(std::string &path);
+
+    int open_manifest(const std::string &path);
+
+    void close_manifest(void);
+
+    static void prefetch(const std::string &path);
+
+private:
+    const std::vector<std::string> &m_items;
+    size_t m_item_index;
+    const size_t m_prefetch_depth;
+    std::deque<std::string> m_window;
+    bool m_is_batch;
+    bool m_is_valid;
+    int m_shard_index;
+    int m_shard_count;
+
+    FILE *m_manifest_stream;
+    const char *m_manifest_map;
+    size_t m_manifest_size;
+    size_t m_manifest_offset;
+    char *m_line_buf;
+    size_t m_line_cap;
+
+    struct dir_frame
+    {
+        DIR *dir;
+        std::string path;
+    };
+    std::vector<dir_frame> m_dir_stack;
+};
+
+#endif /* #ifndef __IMAGE_LIST_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Add set_shard().
+ *  03. Add is_valid().
+ */
@@ -0,0 +1,104 @@
+/*
+ * Histogram of latencies, for statistics over a rolling window.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "latency_histogram.hpp"
+
+#include <algorithm>
+
+// The last bucket has no upper bound.
+static const double BUCKET_BOUNDS_MS[LATENCY_BUCKET_COUNT - 1] = {
+    5, 10, 15, 20, 30, 40, 50, 75, 100, 150, 200, 300, 500, 1000, 5000
+};
+
+latency_histogram_c::latency_histogram_c()
+{
+    reset();
+}
+
+void latency_histogram_c::record(double latency_ms)
+{
+    // Bounds are inclusive.
+    int i = std::lower_bound(BUCKET_BOUNDS_MS, BUCKET_BOUNDS_MS + LATENCY_BUCKET_COUNT - 1, latency_ms)
+        - BUCKET_BOUNDS_MS;
+
+    ++m_buckets[i];
+    ++m_count;
+    m_sum_ms += latency_ms;
+    m_min_ms = std::min(m_min_ms, latency_ms);
+    m_max_ms = std::max(m_max_ms, latency_ms);
+}
+
+void latency_histogram_c::reset(void)
+{
+    std::fill(m_buckets, m_buckets + LATENCY_BUCKET_COUNT, 0);
+    m_count = 0;
+    m_sum_ms = 0;
+    m_min_ms = 1e9;
+    m_max_ms = 0;
+}
+
+double latency_histogram_c::percentile(double pct) const
+{
+    uint64_t rank = (uint64_t)(m_count * pct / 100);
+    uint64_t accumulated = 0;
+
+    if (0 == m_count)
+        return -1;
+
+    for (int i = 0; i < LATENCY_BUCKET_COUNT - 1; ++i)
+    {
+        accumulated += m_buckets[i];
+        if (accumulated > rank)
+            return std::min(BUCKET_BOUNDS_MS[i], m_max_ms);
+    }
+
+    return m_max_ms;
+}
+
+void latency_histogram_c::dump(FILE *stream, const char *title) const
+{
+    if (0 == m_count)
+    {
+        fprintf(stream, "%s: n=0\n", title);
+        return;
+    }
+
+    fprintf(stream, "%s: n=%llu min=%.1f mean=%.1f max=%.1f p50<=%.0f p90<=%.0f p99<=%.0f (ms) |", title,
+        (unsigned long long)m_count, m_min_ms, m_sum_ms / m_count, m_max_ms,
+        percentile(50), percentile(90), percentile(99));
+    for (int i = 0; i < LATENCY_BUCKET_COUNT; ++i)
+    {
+        if (0 == m_buckets[i])
+            continue;
+
+        if (i < LATENCY_BUCKET_COUNT - 1)
+            fprintf(stream, " <=%.0f:%llu", BUCKET_BOUNDS_MS[i], (unsigned long long)m_buckets[i]);
+        else
+            fprintf(stream, " >%.0f:%llu", BUCKET_BOUNDS_MS[i - 1], (unsigned long long)m_buckets[i]);
+    }
+    fprintf(stream, "\n");
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ */
@@ -0,0 +1,70 @@
+/*
+ * Histogram of latencies, for statistics over a rolling window.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __LATENCY_HISTOGRAM_HPP__
+#define __LATENCY_HISTOGRAM_HPP__
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define LATENCY_BUCKET_COUNT            16
+
+/*
+ * Latencies are counted into buckets of fixed upper bounds from 5ms to 5s, plus one for anything beyond,
+ * so that recording costs nothing, and percentiles are reported as the bounds of buckets they fall into.
+ * Minimum, maximum and mean are exact. The window is whatever has been recorded since the last reset.
+ */
+class latency_histogram_c
+{
+public:
+    latency_histogram_c();
+
+public:
+    void record(double latency_ms);
+
+    void reset(void);
+
+    uint64_t count(void) const
+    {
+        return m_count;
+    }
+
+    // Upper bound of the bucket which the percentile (0 ~ 100) falls into, or a negative value if nothing recorded.
+    double percentile(double pct) const;
+
+    // Prefixed by title, in one line.
+    void dump(FILE *stream, const char *title) const;
+
+private:
+    uint64_t m_buckets[LATENCY_BUCKET_COUNT];
+    uint64_t m_count;
+    double m_sum_ms;
+    double m_min_ms;
+    double m_max_ms;
+};
+
+#endif /* #ifndef __LATENCY_HISTOGRAM_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ */
@@ -0,0 +1,298 @@
+/*
+ * Asynchronous logger with a lock-free ring buffer.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "logger.hpp"
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include <atomic>
+#include <thread>
+
+#define LOG_SLOT_COUNT                  4096 // must be a power of 2
+#define LOG_MSG_MAX                     224
+#define LOG_FILE_BUF_SIZE               (64 * 1024)
+#define LOG_IDLE_SLEEP_MIN_US           500
+#define LOG_IDLE_SLEEP_MAX_US           20000
+
+/*
+ * A bounded queue in the way of Dmitry Vyukov: each slot carries a sequence number,
+ * which tells producers whether it's free and tells the consumer whether it's filled.
+ */
+typedef struct log_slot
+{
+    std::atomic<uint64_t> seq;
+    struct timespec ts;
+    const char *file;
+    int line;
+    int level;
+    int tid;
+    int len;
+    char msg[LOG_MSG_MAX];
+} log_slot_t;
+
+static const char *S_LEVEL_NAMES[] = { "debug", "info", "notice", "warning", "error", "critical" };
+static const char S_LEVEL_TAGS[] = { 'D', 'I', 'N', 'W', 'E', 'C' };
+
+int g_log_threshold = LOG_LEVEL_WARNING;
+
+static log_slot_t *s_slots = nullptr;
+static std::atomic<uint64_t> s_head(0);
+static uint64_t s_tail = 0; // owned by the consumer thread
+static std::atomic<uint64_t> s_dropped(0);
+static std::atomic<bool> s_running(false);
+static std::thread s_consumer;
+static FILE *s_stream = nullptr;
+static char *s_stream_buf = nullptr;
+
+static inline int get_tid(void)
+{
+    static thread_local int tid = (int)syscall(SYS_gettid);
+
+    return tid;
+}
+
+static const char* base_name(const char *path)
+{
+    const char *slash = strrchr(path, '/');
+
+    return (nullptr == slash) ? path : (slash + 1);
+}
+
+static void write_line(FILE *stream, const struct timespec &ts, int level, int tid, const char *file, int line,
+    const char *msg, int len)
+{
+    static thread_local time_t s_last_sec = -1;
+    static thread_local char s_time_str[32];
+
+    // Formatting of date and time is expensive, so it's done once per second.
+    if (ts.tv_sec != s_last_sec)
+    {
+        struct tm tm;
+
+        localtime_r(&ts.tv_sec, &tm);
+        strftime(s_time_str, sizeof(s_time_str), "%Y-%m-%d %H:%M:%S", &tm);
+        s_last_sec = ts.tv_sec;
+    }
+
+    fprintf(stream, "%s.%03ld [%c] %d %s:%d: %.*s\n", s_time_str, ts.tv_nsec / 1000000, S_LEVEL_TAGS[level], tid,
+        base_name(file), line, len, msg);
+}
+
+static bool consume_one(void)
+{
+    log_slot_t &slot = s_slots[s_tail & (LOG_SLOT_COUNT - 1)];
+
+    if (slot.seq.load(std::memory_order_acquire) != s_tail + 1)
+        return false;
+
+    write_line(s_stream, slot.ts, slot.level, slot.tid, slot.file, slot.line, slot.msg, slot.len);
+    if (slot.level >= LOG_LEVEL_ERROR)
+        write_line(stderr, slot.ts, slot.level, slot.tid, slot.file, slot.line, slot.msg, slot.len);
+
+    slot.seq.store(s_tail + LOG_SLOT_COUNT, std::memory_order_release);
+    ++s_tail;
+
+    return true;
+}
+
+static void consumer_loop(void)
+{
+    useconds_t sleep_us = LOG_IDLE_SLEEP_MIN_US;
+    uint64_t reported_drops = 0;
+
+    while (true)
+    {
+        bool running = s_running.load(std::memory_order_acquire);
+        int count = 0;
+
+        while (consume_one())
+        {
+            ++count;
+        }
+
+        uint64_t drops = s_dropped.load(std::memory_order_relaxed);
+
+        if (drops != reported_drops)
+        {
+            fprintf(s_stream, "*** %llu log messages dropped since ring buffer is full\n",
+                (unsigned long long)(drops - reported_drops));
+            reported_drops = drops;
+        }
+
+        if (count > 0)
+        {
+            fflush(s_stream);
+            sleep_us = LOG_IDLE_SLEEP_MIN_US;
+        }
+        else if (!running)
+            break;
+        else
+        {
+            // Nothing to do, back off gradually so that an idle logger costs next to nothing.
+            usleep(sleep_us);
+            sleep_us = (sleep_us * 2 > LOG_IDLE_SLEEP_MAX_US) ? LOG_IDLE_SLEEP_MAX_US : sleep_us * 2;
+        }
+    }
+
+    fflush(s_stream);
+}
+
+int log_level_from_name(const char *name)
+{
+    for (size_t i = 0; i < sizeof(S_LEVEL_NAMES) / sizeof(S_LEVEL_NAMES[0]); ++i)
+    {
+        if (0 == strcasecmp(name, S_LEVEL_NAMES[i]))
+            return (int)i;
+    }
+
+    return -EINVAL;
+}
+
+int logger_open(const char *path, int threshold)
+{
+    if (threshold < LOG_LEVEL_DEBUG || threshold > LOG_LEVEL_CRITICAL)
+        return -EINVAL;
+
+    g_log_threshold = threshold;
+
+    if (nullptr == path || '\0' == path[0])
+        return 0;
+
+    if (nullptr == (s_stream = fopen(path, "ae")))
+    {
+        int err = errno;
+
+        fprintf(stderr, "*** Failed to open log file %s: %s\n", path, strerror(err));
+        return -err;
+    }
+
+    s_stream_buf = new char[LOG_FILE_BUF_SIZE];
+    setvbuf(s_stream, s_stream_buf, _IOFBF, LOG_FILE_BUF_SIZE);
+
+    s_slots = new log_slot_t[LOG_SLOT_COUNT];
+    for (uint64_t i = 0; i < LOG_SLOT_COUNT; ++i)
+    {
+        s_slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+    s_head.store(0, std::memory_order_relaxed);
+    s_tail = 0;
+    s_running.store(true, std::memory_order_release);
+    s_consumer = std::thread(consumer_loop);
+
+    return 0;
+}
+
+void logger_close(void)
+{
+    if (nullptr == s_slots)
+        return;
+
+    s_running.store(false, std::memory_order_release);
+    s_consumer.join();
+
+    // Messages written from now on go to stderr.
+    log_slot_t *slots = s_slots;
+
+    s_slots = nullptr;
+    delete[] slots;
+
+    fclose(s_stream);
+    s_stream = nullptr;
+    delete[] s_stream_buf;
+    s_stream_buf = nullptr;
+}
+
+void logger_write(int level, const char *file, int line, const char *fmt, ...)
+{
+    va_list args;
+    log_slot_t *slot;
+    uint64_t pos;
+
+    if (nullptr == s_slots)
+    {
+        struct timespec ts;
+        char msg[LOG_MSG_MAX];
+        int len;
+
+        clock_gettime(CLOCK_REALTIME, &ts);
+        va_start(args, fmt);
+        len = vsnprintf(msg, sizeof(msg), fmt, args);
+        va_end(args);
+        write_line(stderr, ts, level, get_tid(), file, line, msg, (len < (int)sizeof(msg)) ? len : (int)sizeof(msg) - 1);
+
+        return;
+    }
+
+    pos = s_head.load(std::memory_order_relaxed);
+    while (true)
+    {
+        slot = &s_slots[pos & (LOG_SLOT_COUNT - 1)];
+
+        int64_t diff = (int64_t)(slot->seq.load(std::memory_order_acquire) - pos);
+
+        if (0 == diff)
+        {
+            if (s_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            // Full. Never block the caller, which may be in a time-critical loop.
+            s_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else
+            pos = s_head.load(std::memory_order_relaxed);
+    }
+
+    clock_gettime(CLOCK_REALTIME_COARSE, &slot->ts);
+    slot->file = file;
+    slot->line = line;
+    slot->level = level;
+    slot->tid = get_tid();
+    va_start(args, fmt);
+    slot->len = vsnprintf(slot->msg, sizeof(slot->msg), fmt, args);
+    va_end(args);
+    if (slot->len >= (int)sizeof(slot->msg))
+        slot->len = sizeof(slot->msg) - 1;
+    else if (slot->len < 0)
+        slot->len = 0;
+
+    slot->seq.store(pos + 1, std::memory_order_release);
+}
+
+uint64_t logger_dropped_count(void)
+{
+    return s_dropped.load(std::memory_order_relaxed);
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ */
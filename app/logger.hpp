@@ -0,0 +1,79 @@
+/*
+ * Asynchronous logger with a lock-free ring buffer.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __LOGGER_HPP__
+#define __LOGGER_HPP__
+
+#include <stdint.h>
+
+enum
+{
+    LOG_LEVEL_DEBUG,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_NOTICE,
+    LOG_LEVEL_WARNING,
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_CRITICAL,
+};
+
+// Messages below this level are filtered out by the macros below, before any argument is evaluated.
+extern int g_log_threshold;
+
+// Returns a negative number if the name is not one of "debug", "info", "notice", "warning", "error" and "critical".
+int log_level_from_name(const char *name);
+
+/*
+ * If path is null or empty, messages are written to stderr synchronously, which is also the case before opening.
+ * Otherwise, producers only copy messages into a preallocated ring buffer without any lock or system call,
+ * and a background thread takes them out, adds timestamps and levels, and writes them to file in batches
+ * (messages of error and above are also echoed to stderr).
+ * Messages are dropped (and counted) instead of blocking producers if the ring buffer is full.
+ */
+int logger_open(const char *path, int threshold);
+
+// Drains the ring buffer before returning, and should be called after other threads stop logging.
+void logger_close(void);
+
+void logger_write(int level, const char *file, int line, const char *fmt, ...) __attribute__((format(printf, 4, 5)));
+
+uint64_t logger_dropped_count(void);
+
+#define log_enabled(level)              __builtin_expect((level) >= g_log_threshold, 0)
+
+#define log_msg(level, fmt, ...)        do { \
+    if (log_enabled(level)) \
+        logger_write(level, __FILE__, __LINE__, fmt, ##__VA_ARGS__); \
+} while (0)
+
+#define log_debug(fmt, ...)             log_msg(LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#define log_info(fmt, ...)              log_msg(LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#define log_notice(fmt, ...)            log_msg(LOG_LEVEL_NOTICE, fmt, ##__VA_ARGS__)
+#define log_warning(fmt, ...)           log_msg(LOG_LEVEL_WARNING, fmt, ##__VA_ARGS__)
+#define log_error(fmt, ...)             log_msg(LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#define log_critical(fmt, ...)          log_msg(LOG_LEVEL_CRITICAL, fmt, ##__VA_ARGS__)
+
+#endif /* #ifndef __LOGGER_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ */
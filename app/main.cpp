@@ -25,42 +25,37 @@
 #include "versions.hpp"
 #include "cmdline_args.hpp"
 #include "biz_common.hpp"
-
-typedef struct conf_file
-{
-#ifdef HAS_CONFIG_FILE
-    std::string path;
-#endif
-} conf_file_t;
+#include "conf_file.hpp"
+#include "logger.hpp"
 
 static int load_config_file(const char *path, conf_file_t &result)
 {
 #ifdef HAS_CONFIG_FILE
-    todo();
-#endif
+    return conf_file_load(path, result);
+#else
     return 0;
+#endif
 }
 
 static void unload_config_file(conf_file_t &result)
 {
 #ifdef HAS_CONFIG_FILE
-    todo();
+    conf_file_unload(result);
 #endif
 }
 
 int logger_init(const cmd_args_t &args, const conf_file_t &conf)
 {
 #ifdef HAS_LOGGER
-    todo();
+    return logger_open(args.log_file.c_str(), log_level_from_name(args.log_level.c_str()));
+#else
+    return logger_open(nullptr, args.debug ? LOG_LEVEL_DEBUG : (args.verbose ? LOG_LEVEL_INFO : LOG_LEVEL_WARNING));
 #endif
-    return 0;
 }
 
 void logger_finalize(void)
 {
-#ifdef HAS_LOGGER
-    todo();
-#endif
+    logger_close();
 }
 
 static int register_signals(const cmd_args_t &args, const conf_file_t &conf)
@@ -75,6 +70,14 @@ static int register_signals(const cmd_args_t &args, const conf_file_t &conf)
     }
 #endif
 
+#ifdef HAS_CONFIG_FILE
+    if (conf_file_watch_signal() < 0)
+    {
+        perror("conf_file_watch_signal() failed");
+        return EXIT_FAILURE;
+    }
+#endif
+
     return EXIT_SUCCESS;
 }
 
@@ -88,6 +91,15 @@ int main(int argc, char **argv)
             {
                 { "camera", BIZ_FUN(detect_from_camera) },
                 { "pic", BIZ_FUN(detect_from_images) },
+                { "replay", BIZ_FUN(detect_from_camera) },
+                { "shm", BIZ_FUN(detect_from_camera) },
+                { "stdin", BIZ_FUN(detect_from_camera) },
+            }
+        },
+        {
+            "merge",
+            {
+                { "pic", BIZ_FUN(merge_image_results) },
             }
         },
         {
@@ -149,5 +161,12 @@ lbl_unload_conf:
  *
  * >>> 2024-05-18, Man Hung-Coeng <udc577@126.com>:
  *  01. Register several OS signals.
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Implement loading of configuration file, and reload it on SIGHUP.
+ *  02. Implement logger initialization and finalization.
+ *  03. Add a normal biz type of detecting from recording file.
+ *  04. Add a normal biz type of detecting from shared memory.
+ *  05. Add a normal biz type of detecting from stdin.
+ *  06. Add a merge biz type of merging result files of image shards.
  */
-
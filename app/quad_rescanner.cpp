@@ -0,0 +1,230 @@
+/*
+ * Rescan of the region where a barcode was found, rectified by its quad.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "quad_rescanner.hpp"
+
+#include <math.h>
+
+#include <vector>
+#include <algorithm>
+
+#include <opencv2/imgproc.hpp>
+
+#include "decoder_engine.hpp"
+
+#define RESCAN_MAX_MISSES               3
+#define RESCAN_MODULE_PIXELS            3.0f // comfortable for binarizers of ZXing
+#define RESCAN_SCALE_MIN                0.25f
+#define RESCAN_SCALE_MAX                4.0f
+#define RESCAN_SCALE_TOLERANCE          0.2f // not worth resizing within it
+#define RESCAN_SIDE_MAX                 1024 // in pixels of crop
+#define RESCAN_SIDE_MIN                 16 // in pixels of frame, smaller quads are ignored
+#define RESCAN_MIN_RUNS                 8 // fewer runs tell nothing about module size
+#define RESCAN_MIN_CONTRAST             32
+#define QUIET_ZONE_RATIO                0.15f // of each side, on both ends
+#define QUIET_ZONE_MIN                  8.0f // in pixels of frame
+#define LINEAR_HEIGHT_RATIO             0.25f // of width, for linear barcodes located by scan lines
+
+static inline float distance(const cv::Point2f &a, const cv::Point2f &b)
+{
+    return hypotf(a.x - b.x, a.y - b.y);
+}
+
+/*
+ * Width of the narrowest modules along a line of luma, estimated as the lower octile of lengths of runs
+ * between the first edge and the last one, or 0 if the line is too flat or has too few runs.
+ */
+static float estimate_module_size(const uint8_t *pixels, int count, size_t step)
+{
+    int lo = 255;
+    int hi = 0;
+    std::vector<int> runs;
+
+    for (int i = 0; i < count; ++i)
+    {
+        lo = std::min(lo, (int)pixels[i * step]);
+        hi = std::max(hi, (int)pixels[i * step]);
+    }
+
+    if (hi - lo < RESCAN_MIN_CONTRAST)
+        return 0;
+
+    int threshold = (lo + hi) / 2;
+    bool is_dark = pixels[0] < threshold;
+    int edge = -1; // runs before the first edge and after the last one are quiet zones
+
+    for (int i = 1; i < count; ++i)
+    {
+        if ((pixels[i * step] < threshold) == is_dark)
+            continue;
+
+        if (edge >= 0)
+            runs.push_back(i - edge);
+        edge = i;
+        is_dark = !is_dark;
+    }
+
+    if (runs.size() < RESCAN_MIN_RUNS)
+        return 0;
+
+    std::nth_element(runs.begin(), runs.begin() + runs.size() / 8, runs.end());
+
+    return runs[runs.size() / 8];
+}
+
+quad_rescanner_c::quad_rescanner_c(bool enabled)
+    : m_enabled(enabled)
+    , m_engine(enabled ? decoder_engine_c::create("zxing") : nullptr)
+    , m_has_quad(false)
+    , m_format(ZXing::BarcodeFormat::None)
+    , m_misses(0)
+    , m_hit_count(0)
+{
+}
+
+quad_rescanner_c::~quad_rescanner_c()
+{
+}
+
+bool quad_rescanner_c::feed(const barcode_info_t &info)
+{
+    cv::Point2f corners[4];
+
+    if (!m_enabled || ZXing::DecodeStatus::NotFound == info.status)
+        return false;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        corners[i] = cv::Point2f(info.position[i].x, info.position[i].y);
+    }
+
+    float width = std::max(distance(corners[0], corners[1]), distance(corners[3], corners[2]));
+    float height = std::max(distance(corners[0], corners[3]), distance(corners[1], corners[2]));
+
+    if (width < RESCAN_SIDE_MIN) // not located at all, by engines other than ZXing for example
+        return false;
+
+    // Linear barcodes are located by scan lines, which are thickened into strips across the bars.
+    if (height < width * LINEAR_HEIGHT_RATIO)
+    {
+        cv::Point2f left = (corners[0] + corners[3]) * 0.5f;
+        cv::Point2f right = (corners[1] + corners[2]) * 0.5f;
+        cv::Point2f axis = right - left;
+        float half_height = width * LINEAR_HEIGHT_RATIO / 2;
+        cv::Point2f normal = cv::Point2f(-axis.y, axis.x) * (half_height / distance(left, right)); // downwards
+
+        corners[0] = left - normal;
+        corners[1] = right - normal;
+        corners[2] = right + normal;
+        corners[3] = left + normal;
+        height = half_height * 2;
+    }
+
+    // Margin as quiet zone on all sides.
+    cv::Point2f center = (corners[0] + corners[1] + corners[2] + corners[3]) * 0.25f;
+    float factor = 1.0f + 2 * std::max(QUIET_ZONE_RATIO, QUIET_ZONE_MIN / std::min(width, height));
+
+    for (int i = 0; i < 4; ++i)
+    {
+        m_corners[i] = center + (corners[i] - center) * factor;
+    }
+    m_format = info.format;
+    m_misses = 0;
+    m_has_quad = true;
+
+    return true;
+}
+
+barcode_info_t quad_rescanner_c::rescan(const cv::Mat &frame, const ZXing::DecodeHints &hints)
+{
+    if (!m_has_quad)
+        return make_barcode_info(ZXing::DecodeStatus::NotFound);
+
+    int width = (int)std::max(distance(m_corners[0], m_corners[1]), distance(m_corners[3], m_corners[2]));
+    int height = (int)std::max(distance(m_corners[0], m_corners[3]), distance(m_corners[1], m_corners[2]));
+    cv::Point2f upright[4] = {
+        cv::Point2f(0, 0), cv::Point2f(width - 1, 0), cv::Point2f(width - 1, height - 1), cv::Point2f(0, height - 1)
+    };
+
+    // Fronto-parallel at native resolution first, which costs little more than the area of quad.
+    cv::warpPerspective(frame, m_native, cv::getPerspectiveTransform(m_corners, upright), cv::Size(width, height),
+        cv::INTER_LINEAR, cv::BORDER_REPLICATE);
+    if (1 == m_native.channels())
+        m_luma = m_native;
+    else
+        cv::cvtColor(m_native, m_luma, cv::COLOR_BGR2GRAY);
+
+    // Modules are measured across the middle row, and the middle column which matters to 2D barcodes only.
+    float module_x = estimate_module_size(m_luma.ptr(height / 2), width, 1);
+    float module_y = estimate_module_size(m_luma.ptr(0) + width / 2, height, m_luma.step);
+    float module = (module_x > 0 && module_y > 0) ? std::min(module_x, module_y) : std::max(module_x, module_y);
+    float scale = (module > 0) ? std::min(std::max(RESCAN_MODULE_PIXELS / module, RESCAN_SCALE_MIN), RESCAN_SCALE_MAX)
+        : 1.0f;
+    const cv::Mat *crop = &m_luma;
+
+    scale = std::min(scale, (float)RESCAN_SIDE_MAX / std::max(width, height));
+    if (fabsf(scale - 1.0f) > RESCAN_SCALE_TOLERANCE)
+    {
+        cv::resize(m_luma, m_scaled, cv::Size(), scale, scale, (scale < 1.0f) ? cv::INTER_AREA : cv::INTER_LINEAR);
+        crop = &m_scaled;
+    }
+    else
+        scale = 1.0f;
+
+    ZXing::DecodeHints pure_hints = hints;
+
+    pure_hints.setIsPure(true).setTryHarder(false).setTryRotate(false);
+    if (ZXing::BarcodeFormat::None != m_format)
+        pure_hints.setFormats(m_format);
+
+    auto info = m_engine->decode(*crop, pure_hints);
+
+    if (!barcode_info_ok(info))
+    {
+        if (++m_misses >= RESCAN_MAX_MISSES)
+            m_has_quad = false;
+
+        return info;
+    }
+
+    // Back to the frame, where the quad follows the barcode from now on.
+    std::vector<cv::Point2f> points(4);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        points[i] = cv::Point2f(info.position[i].x / scale, info.position[i].y / scale);
+    }
+    cv::perspectiveTransform(points, points, cv::getPerspectiveTransform(upright, m_corners));
+    for (int i = 0; i < 4; ++i)
+    {
+        info.position[i] = cv::Point(cvRound(points[i].x), cvRound(points[i].y));
+    }
+    ++m_hit_count;
+    feed(info);
+
+    return info;
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ */
@@ -0,0 +1,89 @@
+/*
+ * Rescan of the region where a barcode was found, rectified by its quad.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __QUAD_RESCANNER_HPP__
+#define __QUAD_RESCANNER_HPP__
+
+#include <stdint.h>
+
+#include <memory>
+
+#include <opencv2/core/mat.hpp>
+#include <ZXing/DecodeHints.h>
+
+#include "barcode_info.hpp"
+
+class decoder_engine_c;
+
+/*
+ * The quad of the last barcode located, either decoded or not (a partial detection, such as a checksum error),
+ * is remembered. Labels move little between frames, so the quad (with a margin as quiet zone) is warped into
+ * a fronto-parallel crop, which is scaled to about 3 pixels per module and decoded with pure hints
+ * of the remembered format only. That's much cheaper than passes of tryHarder and tryRotate over the whole frame,
+ * and often succeeds on skewed labels where they fail.
+ * The quad is forgotten after a few rescans in a row fail.
+ */
+class quad_rescanner_c
+{
+public:
+    quad_rescanner_c(bool enabled);
+
+    ~quad_rescanner_c();
+
+public:
+    bool enabled(void) const
+    {
+        return m_enabled;
+    }
+
+    // Remembers the quad of a located barcode, whose position is relative to the frame.
+    // Returns true if remembered.
+    bool feed(const barcode_info_t &info);
+
+    // Frame is either luma or BGR, and the position of result is relative to it.
+    // Returns NotFound at once if there's no quad remembered.
+    barcode_info_t rescan(const cv::Mat &frame, const ZXing::DecodeHints &hints);
+
+    uint64_t hit_count(void) const
+    {
+        return m_hit_count;
+    }
+
+private:
+    const bool m_enabled;
+    std::unique_ptr<decoder_engine_c> m_engine;
+    bool m_has_quad;
+    cv::Point2f m_corners[4]; // top-left, top-right, bottom-right, bottom-left
+    ZXing::BarcodeFormat m_format;
+    int m_misses;
+    uint64_t m_hit_count;
+    cv::Mat m_native;
+    cv::Mat m_luma;
+    cv::Mat m_scaled;
+};
+
+#endif /* #ifndef __QUAD_RESCANNER_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ */
@@ -0,0 +1,105 @@
+/*
+ * Uncompressed frames in common pixel formats.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "raw_frame.hpp"
+
+#include <opencv2/core/mat.hpp>
+
+uint32_t raw_format_from_name(const std::string &name)
+{
+    if ("grey" == name || "gray" == name)
+        return RAW_FORMAT_GREY;
+
+    if ("nv12" == name)
+        return RAW_FORMAT_NV12;
+
+    if ("bgr" == name || "bgr24" == name)
+        return RAW_FORMAT_BGR;
+
+    return 0;
+}
+
+const char* raw_format_name(uint32_t format)
+{
+    switch (format)
+    {
+    case RAW_FORMAT_GREY:
+        return "grey";
+
+    case RAW_FORMAT_NV12:
+        return "nv12";
+
+    case RAW_FORMAT_BGR:
+        return "bgr";
+
+    default:
+        return "unknown";
+    }
+}
+
+size_t raw_frame_min_stride(uint32_t format, int width)
+{
+    switch (format)
+    {
+    case RAW_FORMAT_GREY:
+    case RAW_FORMAT_NV12:
+        return width;
+
+    case RAW_FORMAT_BGR:
+        return (size_t)width * 3;
+
+    default:
+        return 0;
+    }
+}
+
+size_t raw_frame_size(uint32_t format, int width, int height, size_t stride)
+{
+    size_t min_stride = raw_frame_min_stride(format, width);
+
+    if (0 == min_stride || stride < min_stride || width <= 0 || height <= 0)
+        return 0;
+
+    // NV12: full-size luma plane, then interleaved chroma plane of half height.
+    return stride * ((RAW_FORMAT_NV12 == format) ? (height + (height + 1) / 2) : height);
+}
+
+int raw_frame_mat_type(uint32_t format)
+{
+    switch (format)
+    {
+    case RAW_FORMAT_GREY:
+    case RAW_FORMAT_NV12:
+        return CV_8UC1;
+
+    case RAW_FORMAT_BGR:
+        return CV_8UC3;
+
+    default:
+        return -1;
+    }
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ */
@@ -0,0 +1,58 @@
+/*
+ * Uncompressed frames in common pixel formats.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __RAW_FRAME_HPP__
+#define __RAW_FRAME_HPP__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#define RAW_FOURCC(a, b, c, d)          ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+#define RAW_FORMAT_GREY                 RAW_FOURCC('G', 'R', 'E', 'Y')
+#define RAW_FORMAT_NV12                 RAW_FOURCC('N', 'V', '1', '2')
+#define RAW_FORMAT_BGR                  RAW_FOURCC('B', 'G', 'R', '3')
+
+#define RAW_FORMAT_CANDIDATES           "grey,nv12,bgr"
+
+// Returns 0 if the name is not one of RAW_FORMAT_CANDIDATES.
+uint32_t raw_format_from_name(const std::string &name);
+
+const char* raw_format_name(uint32_t format);
+
+// Minimum bytes per row of the first plane, or 0 if format is unknown.
+size_t raw_frame_min_stride(uint32_t format, int width);
+
+// Bytes of all planes, each row of which takes stride bytes, or 0 if format is unknown or stride is too small.
+size_t raw_frame_size(uint32_t format, int width, int height, size_t stride);
+
+// Type of cv::Mat over the first plane, which is luma for NV12, or -1 if format is unknown.
+int raw_frame_mat_type(uint32_t format);
+
+#endif /* #ifndef __RAW_FRAME_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ */
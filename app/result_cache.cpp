@@ -0,0 +1,514 @@
+/*
+ * Persistent cache of detection results keyed by content hash.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "result_cache.hpp"
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <vector>
+
+#include "content_hash.hpp"
+
+#define CACHE_MAGIC                     "BCSCACHE"
+#define CACHE_VERSION                   2 // keys of version 1 are not seeded
+#define CACHE_INITIAL_CAPACITY          4096 // must be a power of 2
+#define CACHE_MAX_LOAD_PERCENT          70
+#define CACHE_MAX_TEXT_LEN              (1024 * 1024)
+
+typedef struct cache_index_header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t slot_size;
+    uint64_t capacity;
+    uint64_t count;
+    uint8_t reserved[32];
+} cache_index_header_t;
+
+typedef struct cache_index_slot
+{
+    uint64_t hash;
+    uint64_t size;
+    uint64_t data_offset;
+    uint32_t data_len;
+    uint32_t used;
+} cache_index_slot_t;
+
+typedef struct cache_record_head
+{
+    int32_t status;
+    int32_t format;
+    int32_t orientation;
+    int32_t bits;
+    int32_t position[8];
+    uint32_t text_len;
+    uint32_t ec_level_len;
+} cache_record_head_t;
+
+static inline cache_index_slot_t* slots_of(cache_index_header_t *header)
+{
+    return (cache_index_slot_t *)(header + 1);
+}
+
+static inline size_t index_file_size(uint64_t capacity)
+{
+    return sizeof(cache_index_header_t) + capacity * sizeof(cache_index_slot_t);
+}
+
+static int init_index_file(int fd, uint64_t capacity)
+{
+    cache_index_header_t header = {};
+
+    memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.version = CACHE_VERSION;
+    header.slot_size = sizeof(cache_index_slot_t);
+    header.capacity = capacity;
+    header.count = 0;
+
+    if (ftruncate(fd, index_file_size(capacity)) < 0
+        || pwrite(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header))
+        return -errno;
+
+    return 0;
+}
+
+static bool is_same_file(int fd, const std::string &path)
+{
+    struct stat fd_stat;
+    struct stat path_stat;
+
+    return 0 == fstat(fd, &fd_stat) && 0 == stat(path.c_str(), &path_stat)
+        && fd_stat.st_dev == path_stat.st_dev && fd_stat.st_ino == path_stat.st_ino;
+}
+
+result_cache_c::result_cache_c()
+    : m_seed(0)
+    , m_index_fd(-1)
+    , m_data_fd(-1)
+    , m_header(nullptr)
+    , m_map_size(0)
+    , m_hits(0)
+    , m_misses(0)
+{
+}
+
+result_cache_c::~result_cache_c()
+{
+    close();
+}
+
+int result_cache_c::open(const std::string &path, const std::string &fingerprint)
+{
+    const std::string &data_path = path + ".dat";
+    struct stat st;
+    int err = 0;
+
+    close();
+    m_path = path;
+    m_seed = xxh64(fingerprint.data(), fingerprint.size());
+
+    if ((m_index_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644)) < 0
+        || (m_data_fd = ::open(data_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644)) < 0)
+    {
+        err = -errno;
+        fprintf(stderr, "*** Failed to open cache file %s: %s\n",
+            (m_index_fd < 0) ? path.c_str() : data_path.c_str(), strerror(-err));
+        close();
+        return err;
+    }
+
+    flock(m_index_fd, LOCK_EX);
+    if (fstat(m_index_fd, &st) < 0)
+        err = -errno;
+    else if (0 == st.st_size)
+        err = init_index_file(m_index_fd, CACHE_INITIAL_CAPACITY);
+    else
+    {
+        // Already initialized by someone else.
+    }
+    // Files of another version (or broken ones) are simply started over, since it's only a cache.
+    if (err >= 0 && -EBADMSG == (err = map_index()))
+    {
+        fprintf(stderr, "Cache file %s is of another version or broken, recreating it\n", path.c_str());
+        err = recreate();
+    }
+    flock(m_index_fd, LOCK_UN);
+
+    if (err < 0)
+    {
+        fprintf(stderr, "*** Failed to initialize cache file %s: %s\n", path.c_str(), strerror(-err));
+        close();
+        return err;
+    }
+
+    return 0;
+}
+
+void result_cache_c::close(void)
+{
+    unmap_index();
+
+    if (m_index_fd >= 0)
+    {
+        ::close(m_index_fd);
+        m_index_fd = -1;
+    }
+
+    if (m_data_fd >= 0)
+    {
+        ::close(m_data_fd);
+        m_data_fd = -1;
+    }
+}
+
+int result_cache_c::map_index(void)
+{
+    struct stat st;
+    void *addr;
+
+    if (fstat(m_index_fd, &st) < 0)
+        return -errno;
+
+    if ((size_t)st.st_size < sizeof(cache_index_header_t))
+        return -EBADMSG;
+
+    if (MAP_FAILED == (addr = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_index_fd, 0)))
+        return -errno;
+
+    cache_index_header_t *header = (cache_index_header_t *)addr;
+
+    if (0 != memcmp(header->magic, CACHE_MAGIC, sizeof(header->magic)) || CACHE_VERSION != header->version
+        || sizeof(cache_index_slot_t) != header->slot_size || 0 == header->capacity
+        || 0 != (header->capacity & (header->capacity - 1))
+        || index_file_size(header->capacity) != (size_t)st.st_size)
+    {
+        munmap(addr, st.st_size);
+        return -EBADMSG;
+    }
+
+    m_header = header;
+    m_map_size = st.st_size;
+
+    return 0;
+}
+
+void result_cache_c::unmap_index(void)
+{
+    if (nullptr != m_header)
+    {
+        munmap(m_header, m_map_size);
+        m_header = nullptr;
+        m_map_size = 0;
+    }
+}
+
+// NOTE: Must be called with the lock of index file held, and the lock is transferred to the new file.
+int result_cache_c::reopen_if_replaced(void)
+{
+    while (!is_same_file(m_index_fd, m_path))
+    {
+        int fd = ::open(m_path.c_str(), O_RDWR | O_CLOEXEC);
+
+        if (fd < 0)
+            return -errno;
+
+        flock(fd, LOCK_EX);
+        unmap_index();
+        ::close(m_index_fd); // also releases the lock of old file
+        m_index_fd = fd;
+
+        int err = map_index();
+
+        if (err < 0)
+            return err;
+    }
+
+    return 0;
+}
+
+/*
+ * NOTE: Must be called with the lock of index file held, and the lock is transferred to the new file.
+ * Both files are replaced by renaming rather than truncated, so that other processes still mapping
+ * or reading the old ones are not hurt.
+ */
+int result_cache_c::recreate(void)
+{
+    const std::string &data_path = m_path + ".dat";
+    const std::string &tmp_path = m_path + ".tmp";
+    int fd;
+    int err;
+
+    if ((fd = ::open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)) < 0)
+        return -errno;
+
+    if (rename(tmp_path.c_str(), data_path.c_str()) < 0)
+    {
+        err = -errno;
+        goto lbl_fail;
+    }
+    ::close(m_data_fd);
+    m_data_fd = fd;
+
+    if ((fd = ::open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)) < 0)
+        return -errno;
+
+    flock(fd, LOCK_EX);
+
+    if ((err = init_index_file(fd, CACHE_INITIAL_CAPACITY)) < 0 || rename(tmp_path.c_str(), m_path.c_str()) < 0)
+    {
+        err = (err < 0) ? err : -errno;
+        goto lbl_fail;
+    }
+
+    ::close(m_index_fd); // also releases the lock of old file
+    m_index_fd = fd;
+
+    return map_index();
+
+lbl_fail:
+    ::close(fd);
+    unlink(tmp_path.c_str());
+
+    return err;
+}
+
+cache_index_slot_t* result_cache_c::find_slot(uint64_t key, uint64_t size, bool for_insert) const
+{
+    uint64_t mask = m_header->capacity - 1;
+    cache_index_slot_t *slots = slots_of(m_header);
+
+    for (uint64_t i = key & mask, n = 0; n <= mask; i = (i + 1) & mask, ++n)
+    {
+        cache_index_slot_t *slot = slots + i;
+
+        // Paired with the release store in insert(), so that other fields are complete if used is set.
+        if (!__atomic_load_n(&slot->used, __ATOMIC_ACQUIRE))
+            return for_insert ? slot : nullptr;
+
+        if (key == slot->hash && size == slot->size)
+            return slot;
+    }
+
+    return nullptr;
+}
+
+// NOTE: Must be called with the lock of index file held.
+int result_cache_c::grow(void)
+{
+    const std::string &tmp_path = m_path + ".tmp";
+    uint64_t capacity = m_header->capacity * 2;
+    int fd = ::open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    int err;
+    void *addr;
+
+    if (fd < 0)
+        return -errno;
+
+    flock(fd, LOCK_EX); // Nobody knows it yet, but the lock will be needed after renaming.
+
+    if ((err = init_index_file(fd, capacity)) < 0)
+        goto lbl_fail;
+
+    if (MAP_FAILED == (addr = mmap(nullptr, index_file_size(capacity), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)))
+    {
+        err = -errno;
+        goto lbl_fail;
+    }
+    else
+    {
+        cache_index_header_t *header = (cache_index_header_t *)addr;
+        cache_index_slot_t *old_slots = slots_of(m_header);
+        cache_index_slot_t *new_slots = slots_of(header);
+
+        for (uint64_t i = 0; i < m_header->capacity; ++i)
+        {
+            if (!old_slots[i].used)
+                continue;
+
+            uint64_t j = old_slots[i].hash & (capacity - 1);
+
+            while (new_slots[j].used)
+            {
+                j = (j + 1) & (capacity - 1);
+            }
+            new_slots[j] = old_slots[i];
+        }
+        header->count = m_header->count;
+        munmap(addr, index_file_size(capacity));
+    }
+
+    if (rename(tmp_path.c_str(), m_path.c_str()) < 0)
+    {
+        err = -errno;
+        goto lbl_fail;
+    }
+
+    unmap_index();
+    ::close(m_index_fd); // also wakes up those waiting on the old file, who will find it replaced
+    m_index_fd = fd;
+
+    return map_index();
+
+lbl_fail:
+    ::close(fd);
+    unlink(tmp_path.c_str());
+
+    return err;
+}
+
+uint64_t result_cache_c::make_key(const void *data, size_t len) const
+{
+    return xxh64(data, len, m_seed);
+}
+
+bool result_cache_c::lookup(uint64_t key, uint64_t size, barcode_info_t &info)
+{
+    cache_index_slot_t *slot;
+    cache_record_head_t head;
+    std::vector<char> buf;
+
+    // The index is replaced by a bigger one when another process grows it, and the old one is no longer updated.
+    if (is_open() && !is_same_file(m_index_fd, m_path))
+    {
+        flock(m_index_fd, LOCK_EX);
+        reopen_if_replaced();
+        flock(m_index_fd, LOCK_UN);
+    }
+
+    slot = is_open() ? find_slot(key, size, false) : nullptr;
+
+    if (nullptr == slot || slot->data_len < sizeof(head))
+        goto lbl_miss;
+
+    buf.resize(slot->data_len);
+    if (pread(m_data_fd, buf.data(), buf.size(), slot->data_offset) != (ssize_t)buf.size())
+        goto lbl_miss;
+
+    memcpy(&head, buf.data(), sizeof(head));
+    if ((uint64_t)sizeof(head) + head.text_len + head.ec_level_len != buf.size())
+        goto lbl_miss;
+
+    info.status = (ZXing::DecodeStatus)head.status;
+    info.format = (ZXing::BarcodeFormat)head.format;
+    info.orientation = head.orientation;
+    info.bits = head.bits;
+    for (int i = 0; i < 4; ++i)
+    {
+        info.position[i] = cv::Point(head.position[i * 2], head.position[i * 2 + 1]);
+    }
+    info.text.assign(buf.data() + sizeof(head), head.text_len);
+    info.ec_level.assign(buf.data() + sizeof(head) + head.text_len, head.ec_level_len);
+    ++m_hits;
+
+    return true;
+
+lbl_miss:
+    ++m_misses;
+
+    return false;
+}
+
+int result_cache_c::insert(uint64_t key, uint64_t size, const barcode_info_t &info)
+{
+    cache_index_slot_t *slot;
+    cache_record_head_t head = {};
+    std::vector<char> buf;
+    off_t offset;
+    int err;
+
+    if (!is_open())
+        return -EBADF;
+
+    if (info.text.size() > CACHE_MAX_TEXT_LEN || info.ec_level.size() > CACHE_MAX_TEXT_LEN)
+        return -E2BIG;
+
+    head.status = (int32_t)info.status;
+    head.format = (int32_t)info.format;
+    head.orientation = info.orientation;
+    head.bits = info.bits;
+    for (int i = 0; i < 4; ++i)
+    {
+        head.position[i * 2] = info.position[i].x;
+        head.position[i * 2 + 1] = info.position[i].y;
+    }
+    head.text_len = info.text.size();
+    head.ec_level_len = info.ec_level.size();
+    buf.resize(sizeof(head) + head.text_len + head.ec_level_len);
+    memcpy(buf.data(), &head, sizeof(head));
+    memcpy(buf.data() + sizeof(head), info.text.data(), head.text_len);
+    memcpy(buf.data() + sizeof(head) + head.text_len, info.ec_level.data(), head.ec_level_len);
+
+    flock(m_index_fd, LOCK_EX);
+
+    if ((err = reopen_if_replaced()) < 0)
+        goto lbl_unlock;
+
+    if ((m_header->count + 1) * 100 > m_header->capacity * CACHE_MAX_LOAD_PERCENT && (err = grow()) < 0)
+        goto lbl_unlock;
+
+    if (nullptr == (slot = find_slot(key, size, true)))
+    {
+        err = -ENOSPC;
+        goto lbl_unlock;
+    }
+
+    if (slot->used) // inserted by someone else
+        goto lbl_unlock;
+
+    if ((offset = lseek(m_data_fd, 0, SEEK_END)) < 0)
+    {
+        err = -errno;
+        goto lbl_unlock;
+    }
+
+    if (pwrite(m_data_fd, buf.data(), buf.size(), offset) != (ssize_t)buf.size())
+    {
+        err = -EIO;
+        goto lbl_unlock;
+    }
+
+    slot->hash = key;
+    slot->size = size;
+    slot->data_offset = offset;
+    slot->data_len = buf.size();
+    __atomic_store_n(&slot->used, 1, __ATOMIC_RELEASE);
+    ++m_header->count;
+
+lbl_unlock:
+    flock(m_index_fd, LOCK_UN);
+
+    return err;
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Seed keys with a fingerprint of detection options, and follow the replaced index on lookup as well.
+ *  03. Recreate files of another version or broken ones, instead of failing.
+ */
@@ -0,0 +1,112 @@
+/*
+ * Persistent cache of detection results keyed by content hash.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __RESULT_CACHE_HPP__
+#define __RESULT_CACHE_HPP__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "barcode_info.hpp"
+
+struct cache_index_header;
+struct cache_index_slot;
+
+/*
+ * The cache consists of two files:
+ *   1) an index file (the specified path), which is a memory-mapped open-addressing hash table
+ *      of fixed-size slots, so that a lookup costs only a few memory accesses;
+ *   2) a data file (the specified path plus ".dat"), which is append-only and holds serialized results.
+ * The key is the XXH64 hash of file contents seeded with a fingerprint of detection options, plus the file size,
+ * so that results of different options never mix, and only successful results are worth inserting,
+ * since a failure may turn into a success with other options or a newer decoder.
+ * Insertions are serialized by an advisory lock on the index file, so that a cache
+ * can be shared by several processes. Files of another version, or broken ones, are recreated empty.
+ */
+class result_cache_c
+{
+public:
+    result_cache_c();
+
+    ~result_cache_c();
+
+public:
+    // Fingerprint describes the options which affect results, such as decoders and scale of decoding.
+    int open(const std::string &path, const std::string &fingerprint);
+
+    void close(void);
+
+    bool is_open(void) const
+    {
+        return nullptr != m_header;
+    }
+
+    uint64_t make_key(const void *data, size_t len) const;
+
+    bool lookup(uint64_t key, uint64_t size, barcode_info_t &info);
+
+    int insert(uint64_t key, uint64_t size, const barcode_info_t &info);
+
+    uint64_t hits(void) const
+    {
+        return m_hits;
+    }
+
+    uint64_t misses(void) const
+    {
+        return m_misses;
+    }
+
+private:
+    int map_index(void);
+
+    void unmap_index(void);
+
+    int reopen_if_replaced(void);
+
+    int recreate(void);
+
+    int grow(void);
+
+    struct cache_index_slot* find_slot(uint64_t key, uint64_t size, bool for_insert) const;
+
+private:
+    std::string m_path;
+    uint64_t m_seed; // of keys, derived from fingerprint
+    int m_index_fd;
+    int m_data_fd;
+    struct cache_index_header *m_header;
+    size_t m_map_size;
+    uint64_t m_hits;
+    uint64_t m_misses;
+};
+
+#endif /* #ifndef __RESULT_CACHE_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Seed keys with a fingerprint of detection options.
+ *  03. Recreate files of another version or broken ones, instead of failing.
+ */
@@ -0,0 +1,401 @@
+/*
+ * Results of batch detection in shards, written by each shard and merged afterwards.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "shard_results.hpp"
+
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <map>
+
+#include "content_hash.hpp"
+
+int shard_of_path(const std::string &path, int shard_count)
+{
+    return (shard_count > 1) ? (int)(xxh64(path.data(), path.size()) % shard_count) : 0;
+}
+
+static void write_json_string(FILE *stream, const std::string &str)
+{
+    fputc('"', stream);
+    for (unsigned char c : str)
+    {
+        switch (c)
+        {
+        case '"':
+            fputs("\\\"", stream);
+            break;
+
+        case '\\':
+            fputs("\\\\", stream);
+            break;
+
+        case '\n':
+            fputs("\\n", stream);
+            break;
+
+        case '\r':
+            fputs("\\r", stream);
+            break;
+
+        case '\t':
+            fputs("\\t", stream);
+            break;
+
+        default:
+            if (c < 0x20)
+                fprintf(stream, "\\u%04x", c);
+            else
+                fputc(c, stream); // UTF-8 as it is
+            break;
+        }
+    }
+    fputc('"', stream);
+}
+
+shard_results_writer_c::shard_results_writer_c()
+    : m_stream(nullptr)
+    , m_total(0)
+    , m_successes(0)
+{
+}
+
+shard_results_writer_c::~shard_results_writer_c()
+{
+    if (nullptr != m_stream)
+        fclose(m_stream); // without trailer, as unfinished
+}
+
+int shard_results_writer_c::open(const std::string &path, int shard_index, int shard_count)
+{
+    if (nullptr == (m_stream = fopen(path.c_str(), "we")))
+    {
+        int err = -errno;
+
+        fprintf(stderr, "*** Failed to open result file %s: %s\n", path.c_str(), strerror(-err));
+
+        return err;
+    }
+
+    m_path = path;
+    m_total = 0;
+    m_successes = 0;
+    fprintf(m_stream, "{\"shard\":%d,\"shards\":%d}\n", shard_index, shard_count);
+
+    return 0;
+}
+
+void shard_results_writer_c::write(const std::string &image_path, const barcode_info_t *info)
+{
+    if (nullptr == m_stream)
+        return;
+
+    ++m_total;
+    fputs("{\"path\":", m_stream);
+    write_json_string(m_stream, image_path);
+    if (nullptr != info && barcode_info_ok(*info))
+    {
+        ++m_successes;
+        fputs(",\"ok\":true,\"format\":", m_stream);
+        write_json_string(m_stream, ZXing::ToString(info->format));
+        fputs(",\"text\":", m_stream);
+        write_json_string(m_stream, info->text);
+    }
+    else
+    {
+        fputs(",\"ok\":false,\"error\":", m_stream);
+        write_json_string(m_stream, (nullptr == info) ? "Unreadable" : ZXing::ToString(info->status));
+    }
+    fputs("}\n", m_stream);
+}
+
+int shard_results_writer_c::close(void)
+{
+    int err = 0;
+
+    if (nullptr == m_stream)
+        return 0;
+
+    fprintf(m_stream, "{\"total\":%llu,\"ok\":%llu}\n", (unsigned long long)m_total, (unsigned long long)m_successes);
+    if (ferror(m_stream))
+        err = -EIO;
+    if (0 != fclose(m_stream) && 0 == err)
+        err = -errno;
+    m_stream = nullptr;
+
+    if (err < 0)
+        fprintf(stderr, "*** Failed to write result file %s: %s\n", m_path.c_str(), strerror(-err));
+
+    return err;
+}
+
+/*
+ * Parses a line written above into fields, with strings unescaped and other values kept as they are.
+ * Nested objects and arrays are not supported, since they're never written.
+ */
+static bool parse_flat_object(const char *line, std::map<std::string, std::string> &fields)
+{
+    const char *p = line;
+    auto skip_spaces = [&p]() {
+        while (' ' == *p || '\t' == *p || '\r' == *p || '\n' == *p)
+        {
+            ++p;
+        }
+    };
+    auto parse_string = [&p](std::string &result) {
+        result.clear();
+        if ('"' != *p++)
+            return false;
+
+        for (; '"' != *p; ++p)
+        {
+            if ('\0' == *p)
+                return false;
+
+            if ('\\' != *p)
+            {
+                result += *p;
+                continue;
+            }
+
+            switch (*++p)
+            {
+            case 'n':
+                result += '\n';
+                break;
+
+            case 'r':
+                result += '\r';
+                break;
+
+            case 't':
+                result += '\t';
+                break;
+
+            case 'u':
+                {
+                    char hex[5] = { 0 };
+
+                    if (4 != strnlen(p + 1, 4))
+                        return false;
+                    memcpy(hex, p + 1, 4);
+                    result += (char)strtol(hex, nullptr, 16); // control characters only
+                    p += 4;
+                }
+                break;
+
+            case '\0':
+                return false;
+
+            default: // ", \ and /
+                result += *p;
+                break;
+            }
+        }
+        ++p;
+
+        return true;
+    };
+
+    fields.clear();
+    skip_spaces();
+    if ('{' != *p++)
+        return false;
+
+    skip_spaces();
+    if ('}' == *p)
+        return true;
+
+    while (true)
+    {
+        std::string key;
+        std::string value;
+
+        skip_spaces();
+        if (!parse_string(key))
+            return false;
+
+        skip_spaces();
+        if (':' != *p++)
+            return false;
+
+        skip_spaces();
+        if ('"' == *p)
+        {
+            if (!parse_string(value))
+                return false;
+        }
+        else
+        {
+            const char *begin = p;
+
+            while ('\0' != *p && ',' != *p && '}' != *p && ' ' != *p)
+            {
+                ++p;
+            }
+            value.assign(begin, p - begin);
+        }
+        fields[key] = value;
+
+        skip_spaces();
+        if ('}' == *p)
+            return true;
+
+        if (',' != *p++)
+            return false;
+    }
+}
+
+// Returns the shard index, or a negative error code.
+static int merge_file(const std::string &path, shard_summary_t &summary, bool &finished)
+{
+    FILE *stream = fopen(path.c_str(), "re");
+    char *line = nullptr;
+    size_t line_cap = 0;
+    int line_no = 0;
+    int shard_index = -1;
+    uint64_t total = 0;
+    uint64_t successes = 0;
+    std::map<std::string, std::string> fields;
+    int err;
+
+    finished = false;
+    if (nullptr == stream)
+    {
+        err = -errno;
+        fprintf(stderr, "*** Failed to open result file %s: %s\n", path.c_str(), strerror(-err));
+        return err;
+    }
+
+    while (getline(&line, &line_cap, stream) > 0)
+    {
+        ++line_no;
+        if (!parse_flat_object(line, fields))
+            goto lbl_broken;
+
+        if (1 == line_no)
+        {
+            int shard_count = atoi(fields["shards"].c_str());
+
+            shard_index = atoi(fields["shard"].c_str());
+            if (fields.end() == fields.find("shard") || shard_count < 1 || shard_count > SHARD_COUNT_MAX
+                || shard_index < 0 || shard_index >= shard_count)
+                goto lbl_broken;
+
+            if (summary.shard_count > 0 && summary.shard_count != shard_count)
+            {
+                fprintf(stderr, "*** Result file %s is of %d shards, while others are of %d!\n",
+                    path.c_str(), shard_count, summary.shard_count);
+                err = -EINVAL;
+                goto lbl_close;
+            }
+            summary.shard_count = shard_count;
+        }
+        else if (finished)
+            goto lbl_broken; // nothing after trailer
+        else if (fields.end() != fields.find("path"))
+        {
+            ++total;
+            if ("true" == fields["ok"])
+                ++successes;
+            else
+                summary.failures.push_back(fields["path"] + ": " + fields["error"]);
+        }
+        else if (fields.end() != fields.find("total"))
+        {
+            if (strtoull(fields["total"].c_str(), nullptr, 10) != total
+                || strtoull(fields["ok"].c_str(), nullptr, 10) != successes)
+                goto lbl_broken;
+            finished = true;
+        }
+        else
+            goto lbl_broken;
+    }
+
+    if (0 == line_no)
+        goto lbl_broken;
+
+    summary.total += total;
+    summary.successes += successes;
+    err = shard_index;
+    goto lbl_close;
+
+lbl_broken:
+    fprintf(stderr, "*** Result file %s is broken at line %d!\n", path.c_str(), line_no);
+    err = -EINVAL;
+
+lbl_close:
+    free(line);
+    fclose(stream);
+
+    return err;
+}
+
+int shard_results_merge(const std::vector<std::string> &files, shard_summary_t &summary)
+{
+    std::vector<int> shard_states; // 0: missing, 1: unfinished, 2: finished
+    int ret = 0;
+
+    summary.shard_count = 0;
+    summary.total = 0;
+    summary.successes = 0;
+    summary.failures.clear();
+
+    for (const auto &path : files)
+    {
+        bool finished;
+        int shard_index = merge_file(path, summary, finished);
+
+        if (shard_index < 0)
+        {
+            ret = shard_index;
+            continue;
+        }
+
+        shard_states.resize(summary.shard_count, 0);
+        if (0 != shard_states[shard_index])
+        {
+            fprintf(stderr, "*** Shard %d/%d is given more than once, the last time by %s!\n",
+                shard_index, summary.shard_count, path.c_str());
+            ret = -EINVAL;
+        }
+        shard_states[shard_index] = finished ? 2 : 1;
+    }
+
+    for (size_t i = 0; i < shard_states.size(); ++i)
+    {
+        if (2 == shard_states[i])
+            continue;
+
+        fprintf(stderr, "*** Shard %zu/%d is %s!\n", i, summary.shard_count,
+            (0 == shard_states[i]) ? "missing" : "unfinished");
+        ret = -EINVAL;
+    }
+
+    return ret;
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ */
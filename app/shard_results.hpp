@@ -0,0 +1,99 @@
+/*
+ * Results of batch detection in shards, written by each shard and merged afterwards.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __SHARD_RESULTS_HPP__
+#define __SHARD_RESULTS_HPP__
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "barcode_info.hpp"
+
+#define SHARD_COUNT_MAX                 4096
+
+/*
+ * Each image belongs to the shard of XXH64 of its path modulo shard count, regardless of the order
+ * in which paths are listed or directories are walked. So every shard must be given the same arguments
+ * of images, with the same working directory.
+ */
+int shard_of_path(const std::string &path, int shard_count);
+
+/*
+ * A result file has one JSON object per line (JSONL):
+ *   1) a header: {"shard":I,"shards":N};
+ *   2) a record per image: {"path":"...","ok":true,"format":"...","text":"..."},
+ *      or {"path":"...","ok":false,"error":"..."};
+ *   3) a trailer once the shard finishes: {"total":T,"ok":K}.
+ * A file without trailer belongs to a shard which is still running, or has been killed.
+ */
+class shard_results_writer_c
+{
+public:
+    shard_results_writer_c();
+
+    ~shard_results_writer_c();
+
+public:
+    int open(const std::string &path, int shard_index, int shard_count);
+
+    bool is_open(void) const
+    {
+        return nullptr != m_stream;
+    }
+
+    // Info is null if the image fails to be loaded.
+    void write(const std::string &image_path, const barcode_info_t *info);
+
+    // Writes the trailer. Returns 0, or a negative error code if anything fails to be written.
+    int close(void);
+
+private:
+    FILE *m_stream;
+    std::string m_path;
+    uint64_t m_total;
+    uint64_t m_successes;
+};
+
+typedef struct shard_summary
+{
+    int shard_count;
+    uint64_t total;
+    uint64_t successes;
+    std::vector<std::string> failures; // as "path: error"
+} shard_summary_t;
+
+/*
+ * Records of all files are summed up, and paths of failed images are collected.
+ * Returns 0, or a negative error code if any file is broken, or if files are of different shard counts,
+ * or if any shard is given twice, missing or unfinished (with the summary of what's read still filled in).
+ */
+int shard_results_merge(const std::vector<std::string> &files, shard_summary_t &summary);
+
+#endif /* #ifndef __SHARD_RESULTS_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ */
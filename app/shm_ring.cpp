@@ -0,0 +1,333 @@
+/*
+ * Ring of raw frames in POSIX shared memory.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "shm_ring.hpp"
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "raw_frame.hpp"
+
+#define SHM_ALIGNMENT                   64
+#define SHM_MAX_SLOTS                   1024
+
+static_assert(64 == sizeof(shm_ring_header_t), "Size of shm_ring_header_t must be 64");
+static_assert(64 == sizeof(shm_slot_header_t), "Size of shm_slot_header_t must be 64");
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+    "Atomics in shared memory must be lock-free");
+
+static int64_t monotonic_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// Not FUTEX_PRIVATE_FLAG, since waiters and wakers are in different processes.
+static void futex_wait(std::atomic<uint32_t> &word, uint32_t expected, int64_t timeout_ns)
+{
+    struct timespec ts = { (time_t)(timeout_ns / 1000000000), (long)(timeout_ns % 1000000000) };
+
+    syscall(SYS_futex, (uint32_t *)&word, FUTEX_WAIT, expected, &ts, nullptr, 0);
+}
+
+static void futex_wake_all(std::atomic<uint32_t> &word)
+{
+    syscall(SYS_futex, (uint32_t *)&word, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+static std::string normalized_name(const std::string &name)
+{
+    return ('/' == name[0]) ? name : ("/" + name);
+}
+
+shm_ring_c::shm_ring_c()
+    : m_is_producer(false)
+    , m_header(nullptr)
+    , m_size(0)
+    , m_header_size(0)
+    , m_slot_count(0)
+    , m_slot_size(0)
+    , m_last_seq(0)
+    , m_next_slot(0)
+{
+}
+
+shm_ring_c::~shm_ring_c()
+{
+    close();
+}
+
+shm_slot_header_t* shm_ring_c::slot_at(uint32_t index) const
+{
+    return (shm_slot_header_t *)((uint8_t *)m_header + m_header_size + index * m_slot_size);
+}
+
+int shm_ring_c::map(int fd, size_t size)
+{
+    void *addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if (MAP_FAILED == addr)
+        return -errno;
+
+    m_header = (shm_ring_header_t *)addr;
+    m_size = size;
+
+    return 0;
+}
+
+int shm_ring_c::create(const std::string &name, uint32_t slot_count, size_t max_frame_size, float fps)
+{
+    size_t slot_size = (sizeof(shm_slot_header_t) + max_frame_size + SHM_ALIGNMENT - 1) / SHM_ALIGNMENT * SHM_ALIGNMENT;
+    size_t size = sizeof(shm_ring_header_t) + slot_size * slot_count;
+    int fd;
+    int err = 0;
+
+    if (name.empty() || slot_count < 2 || slot_count > SHM_MAX_SLOTS || 0 == max_frame_size
+        || max_frame_size > (SIZE_MAX - sizeof(shm_ring_header_t)) / slot_count
+            - SHM_ALIGNMENT - sizeof(shm_slot_header_t))
+        return -EINVAL;
+
+    m_name = normalized_name(name);
+    shm_unlink(m_name.c_str());
+    if ((fd = shm_open(m_name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0660)) < 0)
+    {
+        err = -errno;
+        goto lbl_err;
+    }
+
+    if (ftruncate(fd, size) < 0 || (err = map(fd, size)) < 0)
+    {
+        err = (err < 0) ? err : -errno;
+        ::close(fd);
+        shm_unlink(m_name.c_str());
+        goto lbl_err;
+    }
+    ::close(fd);
+    m_is_producer = true;
+
+    // Pages of a new object are zero-filled, so atomics and reserved fields start from 0.
+    m_header->header_size = sizeof(shm_ring_header_t);
+    m_header->slot_count = slot_count;
+    m_header->slot_size = slot_size;
+    m_header->fps = fps;
+    m_header_size = m_header->header_size;
+    m_slot_count = slot_count;
+    m_slot_size = slot_size;
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(m_header->magic, SHM_RING_MAGIC, sizeof(m_header->magic)); // written last, as a mark of readiness
+
+    return 0;
+
+lbl_err:
+    fprintf(stderr, "*** Failed to create shared memory %s: %s\n", m_name.c_str(), strerror(-err));
+
+    return err;
+}
+
+int shm_ring_c::publish(uint32_t format, int width, int height, size_t stride, const void *pixels)
+{
+    size_t frame_size = raw_frame_size(format, width, height, stride);
+    uint32_t count = m_slot_count;
+    uint64_t seq = m_last_seq + 1;
+    shm_slot_header_t *slot = nullptr;
+
+    if (0 == frame_size || sizeof(shm_slot_header_t) + frame_size > m_slot_size)
+        return -E2BIG;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        shm_slot_header_t *candidate = slot_at((m_next_slot + i) % count);
+        uint64_t old_seq = candidate->seq.load();
+
+        candidate->seq.store(0); // seq_cst, paired with ++readers of consumer
+        if (0 == candidate->readers.load())
+        {
+            slot = candidate;
+            m_next_slot = (m_next_slot + i + 1) % count;
+            break;
+        }
+        candidate->seq.store(old_seq);
+    }
+
+    if (nullptr == slot)
+        return -EBUSY;
+
+    slot->format = format;
+    slot->width = width;
+    slot->height = height;
+    slot->stride = stride;
+    slot->timestamp_ns = monotonic_ns();
+    memcpy(shm_ring_c::pixels_of(slot), pixels, frame_size);
+    slot->seq.store(seq, std::memory_order_release);
+
+    m_last_seq = seq;
+    m_header->last_seq.store(seq, std::memory_order_release);
+    m_header->futex_word.store((uint32_t)seq, std::memory_order_release);
+    futex_wake_all(m_header->futex_word);
+
+    return 0;
+}
+
+int shm_ring_c::attach(const std::string &name)
+{
+    struct stat st;
+    int fd;
+    int err = 0;
+
+    m_name = normalized_name(name);
+    if ((fd = shm_open(m_name.c_str(), O_RDWR | O_CLOEXEC, 0)) < 0)
+    {
+        err = -errno;
+        goto lbl_err;
+    }
+
+    if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(shm_ring_header_t) || (err = map(fd, st.st_size)) < 0)
+    {
+        err = (err < 0) ? err : -EINVAL;
+        ::close(fd);
+        goto lbl_err;
+    }
+    ::close(fd);
+
+    if (0 != memcmp(m_header->magic, SHM_RING_MAGIC, sizeof(m_header->magic)))
+    {
+        close();
+        err = -EINVAL;
+        goto lbl_err;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    // Geometry is taken once, and checked so that no slot overlaps the ring header or lies beyond the mapping,
+    // whatever the producer writes into the header later.
+    m_header_size = m_header->header_size;
+    m_slot_count = m_header->slot_count;
+    m_slot_size = m_header->slot_size;
+    if (m_header_size < sizeof(shm_ring_header_t) || 0 != m_header_size % 8 || m_header_size > m_size
+        || m_slot_size < sizeof(shm_slot_header_t) || 0 != m_slot_size % 8
+        || m_slot_count < 1 || m_slot_count > SHM_MAX_SLOTS
+        || m_slot_size > (m_size - m_header_size) / m_slot_count)
+    {
+        fprintf(stderr, "*** Invalid geometry of ring: header_size = %u, slot_count = %u, slot_size = %llu,"
+            " size = %zu\n", m_header_size, m_slot_count, (unsigned long long)m_slot_size, m_size);
+        close();
+        err = -EINVAL;
+        goto lbl_err;
+    }
+    m_is_producer = false;
+    m_last_seq = 0;
+
+    return 0;
+
+lbl_err:
+    fprintf(stderr, "*** Failed to attach shared memory %s: %s\n", m_name.c_str(), strerror(-err));
+
+    return err;
+}
+
+shm_slot_header_t* shm_ring_c::claim_latest(int timeout_ms)
+{
+    int64_t deadline_ns = monotonic_ns() + (int64_t)timeout_ms * 1000000;
+
+    while (true)
+    {
+        uint32_t futex_word = m_header->futex_word.load(std::memory_order_acquire);
+        shm_slot_header_t *latest = nullptr;
+        uint64_t latest_seq = m_last_seq;
+
+        // Slots skipped by producer make sequence numbers out of order, so all of them are looked at.
+        for (uint32_t i = 0; i < m_slot_count; ++i)
+        {
+            shm_slot_header_t *slot = slot_at(i);
+            uint64_t seq = slot->seq.load(std::memory_order_acquire);
+
+            if (seq > latest_seq)
+            {
+                latest = slot;
+                latest_seq = seq;
+            }
+        }
+
+        if (nullptr != latest)
+        {
+            latest->readers.fetch_add(1); // seq_cst, paired with seq = 0 of producer
+            if (latest->seq.load() != latest_seq)
+            {
+                latest->readers.fetch_sub(1);
+                continue; // overwritten in the meantime
+            }
+
+            size_t frame_size = raw_frame_size(latest->format, latest->width, latest->height, latest->stride);
+
+            // A malformed frame is passed over for good, otherwise it'd be picked again and again as the latest.
+            m_last_seq = latest_seq;
+            if (frame_size > 0 && sizeof(shm_slot_header_t) + frame_size <= m_slot_size)
+                return latest;
+
+            latest->readers.fetch_sub(1);
+            continue;
+        }
+
+        int64_t remaining_ns = deadline_ns - monotonic_ns();
+
+        if (remaining_ns <= 0)
+            return nullptr;
+
+        futex_wait(m_header->futex_word, futex_word, remaining_ns);
+    }
+}
+
+void shm_ring_c::unclaim(shm_slot_header_t *slot)
+{
+    slot->readers.fetch_sub(1, std::memory_order_release);
+}
+
+void shm_ring_c::close(void)
+{
+    if (nullptr == m_header)
+        return;
+
+    munmap(m_header, m_size);
+    m_header = nullptr;
+    m_size = 0;
+
+    if (m_is_producer)
+        shm_unlink(m_name.c_str());
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Pass over malformed frames for good instead of picking them again and again.
+ *  03. Validate geometry of ring on attaching, and keep a copy of it.
+ */
@@ -0,0 +1,135 @@
+/*
+ * Ring of raw frames in POSIX shared memory.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __SHM_RING_HPP__
+#define __SHM_RING_HPP__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <atomic>
+
+/*
+ * Layout of the shared memory object (in native byte order):
+ *   1) a ring header of 64 bytes, see shm_ring_header_t;
+ *   2) followed by slot_count slots of slot_size bytes, each of which is a slot header of 64 bytes
+ *      (see shm_slot_header_t) and pixels of a frame (see raw_frame.hpp for formats).
+ * Frames are numbered from 1 by the producer. A slot is written only when no consumer holds it:
+ *   producer: seq = 0, then skip the slot if readers > 0 (restoring seq), else write pixels and seq = N;
+ *   consumer: ++readers, then give up the slot if seq changed, else use it in place and --readers at last.
+ * header_size and slot_size are multiples of 8, and slot_count is at most 1024.
+ * Consumers wait on futex_word, which the producer bumps and wakes up after publishing each frame.
+ */
+#define SHM_RING_MAGIC                  "BCSSHM01"
+
+typedef struct shm_ring_header
+{
+    char magic[8];
+    uint32_t header_size;
+    uint32_t slot_count;
+    uint64_t slot_size; // including slot header
+    float fps; // nominal, 0 if unknown
+    uint32_t reserved0;
+    std::atomic<uint64_t> last_seq; // of the latest frame, 0 if none
+    std::atomic<uint32_t> futex_word;
+    uint8_t reserved[20];
+} shm_ring_header_t;
+
+typedef struct shm_slot_header
+{
+    std::atomic<uint64_t> seq; // of the frame in slot, 0 if being written
+    std::atomic<uint32_t> readers;
+    uint32_t format; // RAW_FORMAT_*
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride; // bytes per row
+    uint32_t reserved0;
+    uint64_t timestamp_ns; // of monotonic clock
+    uint8_t reserved[24];
+} shm_slot_header_t;
+
+class shm_ring_c
+{
+public:
+    shm_ring_c();
+
+    ~shm_ring_c();
+
+public:
+    // Producer: creates the ring, replacing any existing one of the same name. Name is like "/scanner".
+    int create(const std::string &name, uint32_t slot_count, size_t max_frame_size, float fps);
+
+    // Producer: returns 0, or -EBUSY if all slots are held by consumers, or -E2BIG if the frame doesn't fit.
+    int publish(uint32_t format, int width, int height, size_t stride, const void *pixels);
+
+    // Consumer
+    int attach(const std::string &name);
+
+    // Consumer: waits for a frame newer than the last claimed one for at most timeout_ms,
+    // and holds its slot until unclaim(). Returns null on timeout.
+    shm_slot_header_t* claim_latest(int timeout_ms);
+
+    void unclaim(shm_slot_header_t *slot);
+
+    // Unmaps the ring, and removes it if this is the producer.
+    void close(void);
+
+    bool is_open(void) const
+    {
+        return nullptr != m_header;
+    }
+
+    const shm_ring_header_t* header(void) const
+    {
+        return m_header;
+    }
+
+    static uint8_t* pixels_of(shm_slot_header_t *slot)
+    {
+        return (uint8_t *)(slot + 1);
+    }
+
+private:
+    shm_slot_header_t* slot_at(uint32_t index) const;
+
+    int map(int fd, size_t size);
+
+private:
+    std::string m_name;
+    bool m_is_producer;
+    shm_ring_header_t *m_header;
+    size_t m_size;
+    uint32_t m_header_size; // copies of header, validated on attaching
+    uint32_t m_slot_count;
+    uint64_t m_slot_size;
+    uint64_t m_last_seq; // published by producer, or claimed by consumer
+    uint32_t m_next_slot;
+};
+
+#endif /* #ifndef __SHM_RING_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Keep a validated copy of geometry of ring.
+ */
@@ -0,0 +1,207 @@
+/*
+ * Consensus of decoding results across consecutive frames.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "temporal_consensus.hpp"
+
+#include <math.h>
+#include <ctype.h>
+
+#include <algorithm>
+
+#define TRACK_MAX_GAP                   15 // in frames
+#define TRACK_RADIUS_MIN                40.0f // in pixels
+#define TRACK_RADIUS_FACTOR             1.5f // of the diagonal of barcode
+
+temporal_consensus_c::temporal_consensus_c(int required_votes)
+    : m_required_votes(required_votes)
+    , m_frame_count(0)
+    , m_rejected_count(0)
+{
+}
+
+static bool has_check_digit(ZXing::BarcodeFormat format)
+{
+    return ZXing::BarcodeFormat::EAN8 == format || ZXing::BarcodeFormat::EAN13 == format
+        || ZXing::BarcodeFormat::UPCA == format;
+}
+
+// Check digit of GTIN family: weights are 3 and 1 alternately, starting with 3 from the right.
+static bool is_gtin_valid(const std::string &text)
+{
+    int sum = 0;
+    int weight = 3;
+
+    if (text.size() < 2)
+        return false;
+
+    for (size_t i = text.size() - 1; i-- > 0; weight = 4 - weight)
+    {
+        if (!isdigit((unsigned char)text[i]))
+            return false;
+        sum += (text[i] - '0') * weight;
+    }
+
+    return isdigit((unsigned char)text.back()) && (10 - sum % 10) % 10 == text.back() - '0';
+}
+
+temporal_consensus_c::track_t* temporal_consensus_c::find_track(const barcode_info_t &info, const cv::Point &center)
+{
+    track_t *nearest = nullptr;
+    float nearest_distance = 0;
+
+    for (auto &track : m_tracks)
+    {
+        float distance = hypotf(track.center.x - center.x, track.center.y - center.y);
+
+        if (track.format != info.format || distance > track.radius)
+            continue;
+
+        if (nullptr == nearest || distance < nearest_distance)
+        {
+            nearest = &track;
+            nearest_distance = distance;
+        }
+    }
+
+    return nearest;
+}
+
+bool temporal_consensus_c::vote(track_t &track, const std::string &text, std::string &result) const
+{
+    int &votes = track.votes[text];
+
+    ++track.reads;
+    if (++votes >= m_required_votes)
+    {
+        result = text;
+        return true;
+    }
+
+    if (!has_check_digit(track.format))
+        return false;
+
+    if (track.char_votes.empty())
+        track.char_votes.resize(text.size());
+    if (track.char_votes.size() != text.size())
+        return false;
+
+    int reads_of_same_length = 0;
+
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        ++track.char_votes[i][text[i]];
+    }
+    for (const auto &iter : track.votes)
+    {
+        if (iter.first.size() == text.size())
+            reads_of_same_length += iter.second;
+    }
+    if (reads_of_same_length < m_required_votes)
+        return false;
+
+    std::string merged(text.size(), '\0');
+
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        const auto &candidates = track.char_votes[i];
+
+        merged[i] = std::max_element(candidates.begin(), candidates.end(),
+            [](const std::pair<const char, int> &a, const std::pair<const char, int> &b) {
+                return a.second < b.second;
+            })->first;
+    }
+
+    if (!is_gtin_valid(merged))
+        return false;
+
+    result = merged;
+
+    return true;
+}
+
+bool temporal_consensus_c::feed(const barcode_info_t &info, std::string &text)
+{
+    ++m_frame_count;
+
+    for (auto iter = m_tracks.begin(); iter != m_tracks.end(); )
+    {
+        if (m_frame_count - iter->last_frame <= TRACK_MAX_GAP)
+        {
+            ++iter;
+            continue;
+        }
+
+        if (!iter->emitted)
+            ++m_rejected_count;
+        iter = m_tracks.erase(iter);
+    }
+
+    if (!barcode_info_ok(info))
+        return false;
+
+    if (!enabled())
+    {
+        text = info.text;
+        return true;
+    }
+
+    const auto &pos = info.position;
+    cv::Point center((pos[0].x + pos[1].x + pos[2].x + pos[3].x) / 4, (pos[0].y + pos[1].y + pos[2].y + pos[3].y) / 4);
+    float diagonal = std::max(hypotf(pos[0].x - pos[2].x, pos[0].y - pos[2].y),
+        hypotf(pos[1].x - pos[3].x, pos[1].y - pos[3].y));
+    track_t *track = find_track(info, center);
+
+    if (nullptr == track)
+    {
+        m_tracks.emplace_back();
+        track = &m_tracks.back();
+        track->format = info.format;
+        track->emitted = false;
+        track->reads = 0;
+    }
+
+    // The track follows the label as it moves.
+    track->center = center;
+    track->radius = std::max(TRACK_RADIUS_MIN, diagonal * TRACK_RADIUS_FACTOR);
+    track->last_frame = m_frame_count;
+
+    if ((track->emitted && info.text == track->emitted_text) || !vote(*track, info.text, text))
+        return false;
+
+    // Votes start over, so that another label shown in place of this one is voted on its own.
+    track->votes.clear();
+    track->char_votes.clear();
+    track->reads = 0;
+    if (track->emitted && text == track->emitted_text) // merged into the emitted text again
+        return false;
+
+    track->emitted = true;
+    track->emitted_text = text;
+
+    return true;
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Vote afresh after each emission, for another label in place of the emitted one.
+ */
@@ -0,0 +1,97 @@
+/*
+ * Consensus of decoding results across consecutive frames.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __TEMPORAL_CONSENSUS_HPP__
+#define __TEMPORAL_CONSENSUS_HPP__
+
+#include <stdint.h>
+
+#include <string>
+#include <map>
+#include <list>
+#include <vector>
+
+#include "barcode_info.hpp"
+
+/*
+ * Reads are grouped into tracks by format and position, so that one label moving across the view
+ * stays in one track while different labels don't mix up. A text of track is emitted once:
+ *   1) any text of it has been read required_votes times; or
+ *   2) for EAN/UPC, whose check digit makes it safe, the character-wise majority of
+ *      at least required_votes reads of the same length passes the check, which merges
+ *      partially misread scans into one good result.
+ * Votes start over after each emission, and reads of the emitted text are ignored from then on,
+ * so that another label taking the place of the emitted one in view is voted and emitted as well.
+ * Tracks not seen for a while are dropped.
+ */
+class temporal_consensus_c
+{
+public:
+    // Consensus is disabled if required_votes is less than 2, and every valid read is emitted at once.
+    temporal_consensus_c(int required_votes);
+
+public:
+    bool enabled(void) const
+    {
+        return m_required_votes > 1;
+    }
+
+    // Called once per decoded frame, even if nothing is detected. Returns true if there's text to emit.
+    bool feed(const barcode_info_t &info, std::string &text);
+
+    uint64_t rejected_count(void) const
+    {
+        return m_rejected_count;
+    }
+
+private:
+    typedef struct track
+    {
+        ZXing::BarcodeFormat format;
+        cv::Point center;
+        float radius;
+        uint64_t last_frame;
+        bool emitted;
+        std::string emitted_text;
+        int reads;
+        std::map<std::string, int> votes;
+        std::vector<std::map<char, int>> char_votes; // of reads with the same length as the first one
+    } track_t;
+
+    track_t* find_track(const barcode_info_t &info, const cv::Point &center);
+
+    bool vote(track_t &track, const std::string &text, std::string &result) const;
+
+private:
+    const int m_required_votes;
+    uint64_t m_frame_count;
+    uint64_t m_rejected_count;
+    std::list<track_t> m_tracks;
+};
+
+#endif /* #ifndef __TEMPORAL_CONSENSUS_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Vote afresh after each emission, for another label in place of the emitted one.
+ */
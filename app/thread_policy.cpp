@@ -0,0 +1,224 @@
+/*
+ * CPU affinity and scheduling policy of pipeline threads.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "thread_policy.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+static const char *S_ROLE_NAMES[THREAD_ROLE_COUNT] = {
+    "capture",
+    "decode",
+    "display",
+};
+
+const char* thread_role_name(int role)
+{
+    return (role >= 0 && role < THREAD_ROLE_COUNT) ? S_ROLE_NAMES[role] : "unknown";
+}
+
+static int role_from_name(const std::string &name)
+{
+    for (int i = 0; i < THREAD_ROLE_COUNT; ++i)
+    {
+        if (name == S_ROLE_NAMES[i])
+            return i;
+    }
+
+    return -1;
+}
+
+// CPU list like "0", "4-7" or "0,2,4-7".
+static bool parse_cpu_list(const std::string &list, cpu_set_t &cpus)
+{
+    const char *ptr = list.c_str();
+
+    CPU_ZERO(&cpus);
+
+    while ('\0' != *ptr)
+    {
+        char *end;
+        long first = strtol(ptr, &end, 10);
+        long last = first;
+
+        if (end == ptr || first < 0)
+            return false;
+
+        if ('-' == *end)
+        {
+            ptr = end + 1;
+            last = strtol(ptr, &end, 10);
+            if (end == ptr || last < first)
+                return false;
+        }
+
+        if (last >= CPU_SETSIZE)
+            return false;
+
+        for (long cpu = first; cpu <= last; ++cpu)
+        {
+            CPU_SET(cpu, &cpus);
+        }
+
+        if (',' == *end)
+            ++end;
+        else if ('\0' != *end)
+            return false;
+        ptr = end;
+    }
+
+    return CPU_COUNT(&cpus) > 0;
+}
+
+// Scheduling like "fifo:50", "rr:10", "rr" (lowest priority) or "other".
+static bool parse_sched(const std::string &value, int &policy, int &priority)
+{
+    size_t colon = value.find(':');
+    std::string name = value.substr(0, colon);
+
+    if ("other" == name)
+        policy = SCHED_OTHER;
+    else if ("fifo" == name)
+        policy = SCHED_FIFO;
+    else if ("rr" == name)
+        policy = SCHED_RR;
+    else
+        return false;
+
+    priority = sched_get_priority_min(policy);
+    if (std::string::npos == colon)
+        return true;
+
+    if (SCHED_OTHER == policy)
+        return false;
+
+    char *end;
+    long prio = strtol(value.c_str() + colon + 1, &end, 10);
+
+    if ('\0' != *end || prio < sched_get_priority_min(policy) || prio > sched_get_priority_max(policy))
+        return false;
+
+    priority = prio;
+
+    return true;
+}
+
+// Calls handler(role, value) for each ROLE=VALUE item of spec.
+template<typename handler_t>
+static int parse_role_items(const char *option, const std::string &spec, handler_t handler)
+{
+    size_t begin = 0;
+
+    while (begin < spec.size())
+    {
+        size_t end = spec.find('/', begin);
+        std::string item = spec.substr(begin, (std::string::npos == end) ? std::string::npos : end - begin);
+        size_t equal = item.find('=');
+        int role = role_from_name(item.substr(0, equal));
+
+        if (std::string::npos == equal || role < 0 || !handler(role, item.substr(equal + 1)))
+        {
+            fprintf(stderr, "*** Invalid item of %s: %s\nMust be ROLE=VALUE with ROLE among {%s}\n",
+                option, item.c_str(), THREAD_ROLE_CANDIDATES);
+            return -EINVAL;
+        }
+
+        if (std::string::npos == end)
+            break;
+        begin = end + 1;
+    }
+
+    return 0;
+}
+
+int parse_thread_policies(const std::string &cpus_spec, const std::string &sched_spec, thread_policies_t &policies)
+{
+    int err;
+
+    for (auto &policy : policies)
+    {
+        policy.has_cpus = false;
+        CPU_ZERO(&policy.cpus);
+        policy.sched_policy = SCHED_OTHER;
+        policy.sched_priority = 0;
+    }
+
+    if ((err = parse_role_items("--cpus", cpus_spec, [&policies](int role, const std::string &value) {
+            policies[role].has_cpus = parse_cpu_list(value, policies[role].cpus);
+            return policies[role].has_cpus;
+        })) < 0)
+        return err;
+
+    return parse_role_items("--sched", sched_spec, [&policies](int role, const std::string &value) {
+        return parse_sched(value, policies[role].sched_policy, policies[role].sched_priority);
+    });
+}
+
+void apply_thread_policy(int role, const thread_policy_t &policy)
+{
+    pthread_t self = pthread_self();
+    char name[16];
+    int err;
+
+    // The main thread keeps its name, which is also the name of process.
+    if (getpid() != (pid_t)syscall(SYS_gettid))
+    {
+        snprintf(name, sizeof(name), "bcs-%s", thread_role_name(role));
+        pthread_setname_np(self, name);
+    }
+
+    if (policy.has_cpus && 0 != (err = pthread_setaffinity_np(self, sizeof(policy.cpus), &policy.cpus)))
+        fprintf(stderr, "*** Failed to set CPU affinity of %s thread: %s\n", thread_role_name(role), strerror(err));
+
+    if (SCHED_OTHER != policy.sched_policy)
+    {
+        struct sched_param param = {};
+
+        param.sched_priority = policy.sched_priority;
+        if (0 != (err = pthread_setschedparam(self, policy.sched_policy, &param)))
+        {
+            fprintf(stderr, "*** Failed to set scheduling policy of %s thread: %s\n",
+                thread_role_name(role), strerror(err));
+        }
+    }
+}
+
+double thread_cpu_seconds(pthread_t thread)
+{
+    clockid_t clock_id;
+    struct timespec ts;
+
+    if (0 != pthread_getcpuclockid(thread, &clock_id) || clock_gettime(clock_id, &ts) < 0)
+        return -1;
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ */
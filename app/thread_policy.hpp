@@ -0,0 +1,79 @@
+/*
+ * CPU affinity and scheduling policy of pipeline threads.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __THREAD_POLICY_HPP__
+#define __THREAD_POLICY_HPP__
+
+#include <sched.h>
+#include <pthread.h>
+
+#include <string>
+
+enum
+{
+    THREAD_ROLE_CAPTURE,
+    THREAD_ROLE_DECODE,
+    THREAD_ROLE_DISPLAY,
+
+    THREAD_ROLE_COUNT
+};
+
+#define THREAD_ROLE_CANDIDATES          "capture,decode,display"
+
+typedef struct thread_policy
+{
+    bool has_cpus;
+    cpu_set_t cpus;
+    int sched_policy; // SCHED_OTHER, SCHED_FIFO or SCHED_RR
+    int sched_priority; // for SCHED_FIFO and SCHED_RR only
+} thread_policy_t;
+
+typedef thread_policy_t thread_policies_t[THREAD_ROLE_COUNT];
+
+const char* thread_role_name(int role);
+
+/*
+ * Both specs consist of items of ROLE=VALUE separated by "/", and roles not mentioned keep the defaults of OS.
+ * Values of cpus_spec are CPU lists like "0" and "4-7,2", while values of sched_spec are {other,fifo,rr}[:PRIORITY].
+ * Example: cpus_spec = "capture=0/decode=4-7", sched_spec = "decode=fifo:50".
+ * Returns 0 on success, or -EINVAL with the reason printed.
+ */
+int parse_thread_policies(const std::string &cpus_spec, const std::string &sched_spec, thread_policies_t &policies);
+
+/*
+ * Names the calling thread after the role, and applies the policy to it.
+ * Threads created afterwards by the calling thread (workers of OpenCV and racers of decoders, for example)
+ * inherit the policy.
+ * Failures (EPERM of real-time scheduling without privilege, for example) are reported
+ * but not fatal, since the pipeline works the same except for timing.
+ */
+void apply_thread_policy(int role, const thread_policy_t &policy);
+
+// CPU time consumed by the thread in seconds, or a negative value on error.
+double thread_cpu_seconds(pthread_t thread);
+
+#endif /* #ifndef __THREAD_POLICY_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ */
@@ -0,0 +1,304 @@
+/*
+ * Generator of a synthetic barcode corpus for regression tests.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <getopt.h>
+#include <sys/stat.h>
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <opencv2/core/mat.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <ZXing/BarcodeFormat.h>
+#include <ZXing/BitMatrix.h>
+#include <ZXing/MultiFormatWriter.h>
+
+#define DEFAULT_SEED                    20261019
+#define DEFAULT_OUTPUT_DIR              "corpus"
+#define EXPECTATION_FILE                "expected.tsv"
+#define IMAGE_LIST_FILE                 "list.txt"
+#define QUIET_ZONE                      10 // in modules
+
+static const ZXing::BarcodeFormat FORMATS[] = {
+    ZXing::BarcodeFormat::QRCode,
+    ZXing::BarcodeFormat::DataMatrix,
+    ZXing::BarcodeFormat::Aztec,
+    ZXing::BarcodeFormat::PDF417,
+    ZXing::BarcodeFormat::Code128,
+    ZXing::BarcodeFormat::Code39,
+    ZXing::BarcodeFormat::EAN13,
+    ZXing::BarcodeFormat::EAN8,
+    ZXing::BarcodeFormat::UPCA,
+    ZXing::BarcodeFormat::ITF,
+};
+static const int SIZES[] = { 200, 400, 800 }; // width in pixels before rotation
+static const int ROTATIONS[] = { 0, 15, 45, 90 }; // in degrees
+static const int BLURS[] = { 0, 1, 2 }; // sigma of Gaussian blur
+static const int NOISES[] = { 0, 10, 25 }; // sigma of Gaussian noise
+
+static void usage(const char *prog)
+{
+    printf("Usage: %s [-o DIR] [--seed N]\n"
+        "  -o, --output DIR  Directory of corpus, \"%s\" by default.\n"
+        "      --seed N      Seed of texts and noise, %d by default.\n"
+        "  -h, --help        Show this help.\n", prog, DEFAULT_OUTPUT_DIR, DEFAULT_SEED);
+}
+
+static std::string random_digits(cv::RNG &rng, int count)
+{
+    std::string digits(count, '0');
+
+    for (auto &c : digits)
+    {
+        c = '0' + rng.uniform(0, 10);
+    }
+
+    return digits;
+}
+
+// Appends the check digit of GTIN family.
+static std::string with_gtin_check_digit(const std::string &digits)
+{
+    int sum = 0;
+    int weight = 3;
+
+    for (size_t i = digits.size(); i-- > 0; weight = 4 - weight)
+    {
+        sum += (digits[i] - '0') * weight;
+    }
+
+    return digits + (char)('0' + (10 - sum % 10) % 10);
+}
+
+static std::string make_text(ZXing::BarcodeFormat format, cv::RNG &rng)
+{
+    switch (format)
+    {
+    case ZXing::BarcodeFormat::EAN13:
+        return with_gtin_check_digit(random_digits(rng, 12));
+
+    case ZXing::BarcodeFormat::EAN8:
+        return with_gtin_check_digit(random_digits(rng, 7));
+
+    case ZXing::BarcodeFormat::UPCA:
+        return with_gtin_check_digit(random_digits(rng, 11));
+
+    case ZXing::BarcodeFormat::ITF:
+        return random_digits(rng, 14);
+
+    case ZXing::BarcodeFormat::Code39:
+        return "CORPUS-" + random_digits(rng, 6);
+
+    case ZXing::BarcodeFormat::Code128:
+        return "Corpus-" + random_digits(rng, 8);
+
+    default: // 2D codes
+        return "https://example.com/corpus/" + random_digits(rng, 12);
+    }
+}
+
+static bool is_linear(ZXing::BarcodeFormat format)
+{
+    return ZXing::BarcodeFormat::QRCode != format && ZXing::BarcodeFormat::DataMatrix != format
+        && ZXing::BarcodeFormat::Aztec != format && ZXing::BarcodeFormat::PDF417 != format;
+}
+
+static cv::Mat render(ZXing::BarcodeFormat format, const std::string &text, int size)
+{
+    int height = is_linear(format) ? size / 2 : ((ZXing::BarcodeFormat::PDF417 == format) ? size / 3 : size);
+    ZXing::BitMatrix bits = ZXing::MultiFormatWriter(format).setMargin(0)
+        .encode(std::wstring(text.begin(), text.end()), size, height);
+    ZXing::Matrix<uint8_t> pixels = ZXing::ToMatrix<uint8_t>(bits, 0, 255);
+    cv::Mat symbol(pixels.height(), pixels.width(), CV_8UC1, (void *)pixels.data());
+    cv::Mat image;
+    int margin = std::max(QUIET_ZONE, size / 10);
+
+    cv::copyMakeBorder(symbol, image, margin, margin, margin, margin, cv::BORDER_CONSTANT, cv::Scalar(255));
+
+    return image;
+}
+
+static cv::Mat rotate(const cv::Mat &image, int degrees)
+{
+    if (0 == degrees)
+        return image;
+
+    double radians = degrees * M_PI / 180;
+    double abs_cos = fabs(cos(radians));
+    double abs_sin = fabs(sin(radians));
+    cv::Size size(lround(image.cols * abs_cos + image.rows * abs_sin), lround(image.cols * abs_sin + image.rows * abs_cos));
+    cv::Mat matrix = cv::getRotationMatrix2D(cv::Point2f(image.cols / 2.0f, image.rows / 2.0f), degrees, 1.0);
+    cv::Mat rotated;
+
+    // Moves the center to the center of the enlarged canvas, so that no corner is cut off.
+    matrix.at<double>(0, 2) += (size.width - image.cols) / 2.0;
+    matrix.at<double>(1, 2) += (size.height - image.rows) / 2.0;
+    cv::warpAffine(image, rotated, matrix, size, cv::INTER_LINEAR, cv::BORDER_CONSTANT, cv::Scalar(255));
+
+    return rotated;
+}
+
+static void degrade(cv::Mat &image, int blur, int noise, cv::RNG &rng)
+{
+    if (blur > 0)
+        cv::GaussianBlur(image, image, cv::Size(0, 0), blur);
+
+    if (noise > 0)
+    {
+        cv::Mat wide;
+        cv::Mat gaussian(image.rows, image.cols, CV_16S);
+
+        rng.fill(gaussian, cv::RNG::NORMAL, cv::Scalar(0), cv::Scalar(noise));
+        image.convertTo(wide, CV_16S);
+        cv::add(wide, gaussian, wide);
+        wide.convertTo(image, CV_8U); // saturated
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const struct option OPTIONS[] = {
+        { "output", required_argument, nullptr, 'o' },
+        { "seed", required_argument, nullptr, 's' },
+        { "help", no_argument, nullptr, 'h' },
+        { nullptr, 0, nullptr, 0 }
+    };
+    std::string dir = DEFAULT_OUTPUT_DIR;
+    uint64_t seed = DEFAULT_SEED;
+    int opt;
+
+    while (-1 != (opt = getopt_long(argc, argv, "o:h", OPTIONS, nullptr)))
+    {
+        switch (opt)
+        {
+        case 'o':
+            dir = optarg;
+            break;
+
+        case 's':
+            seed = strtoull(optarg, nullptr, 0);
+            break;
+
+        case 'h':
+            usage(argv[0]);
+            return EXIT_SUCCESS;
+
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (mkdir(dir.c_str(), 0755) < 0 && EEXIST != errno)
+    {
+        fprintf(stderr, "*** Failed to create directory %s: %s\n", dir.c_str(), strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    std::string expectation_path = dir + "/" EXPECTATION_FILE;
+    std::string list_path = dir + "/" IMAGE_LIST_FILE;
+    FILE *expectation = fopen(expectation_path.c_str(), "w");
+    FILE *list = fopen(list_path.c_str(), "w");
+    cv::RNG rng(seed);
+    int count = 0;
+    int ret = EXIT_SUCCESS;
+
+    if (nullptr == expectation || nullptr == list)
+    {
+        fprintf(stderr, "*** Failed to create %s or %s: %s\n", expectation_path.c_str(), list_path.c_str(), strerror(errno));
+        ret = EXIT_FAILURE;
+        goto lbl_close;
+    }
+
+    fprintf(expectation, "# file\tformat\ttext\n");
+
+    // Everything is derived from the seed in a fixed order, so that the corpus is the same on every run.
+    for (ZXing::BarcodeFormat format : FORMATS)
+    {
+        std::string text = make_text(format, rng);
+        const char *format_name = ZXing::ToString(format);
+
+        for (int size : SIZES)
+        {
+            cv::Mat symbol;
+
+            try
+            {
+                symbol = render(format, text, size);
+            }
+            catch (std::exception &e)
+            {
+                fprintf(stderr, "*** Failed to encode %s of size %d: %s\n", format_name, size, e.what());
+                ret = EXIT_FAILURE;
+                goto lbl_close;
+            }
+
+            for (int rotation : ROTATIONS)
+            {
+                cv::Mat rotated = rotate(symbol, rotation);
+
+                for (int blur : BLURS)
+                {
+                    for (int noise : NOISES)
+                    {
+                        char name[128];
+                        cv::Mat image = rotated.clone();
+
+                        degrade(image, blur, noise, rng);
+                        snprintf(name, sizeof(name), "%s_%d_r%d_b%d_n%d.png", format_name, size, rotation, blur, noise);
+                        if (!cv::imwrite(dir + "/" + name, image))
+                        {
+                            fprintf(stderr, "*** Failed to write %s/%s\n", dir.c_str(), name);
+                            ret = EXIT_FAILURE;
+                            goto lbl_close;
+                        }
+                        fprintf(expectation, "%s\t%s\t%s\n", name, format_name, text.c_str());
+                        fprintf(list, "%s/%s\n", dir.c_str(), name);
+                        ++count;
+                    }
+                }
+            }
+        }
+    }
+
+    printf("%d images generated in %s with seed %llu\n", count, dir.c_str(), (unsigned long long)seed);
+
+lbl_close:
+    if (nullptr != list)
+        fclose(list);
+    if (nullptr != expectation)
+        fclose(expectation);
+
+    return ret;
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ */
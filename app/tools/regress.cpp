@@ -0,0 +1,518 @@
+/*
+ * Regression harness running the decoding path of scanner over a corpus.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+#include <opencv2/core/mat.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+#include "decoder_engine.hpp"
+#include "barcode_localizer.hpp"
+
+#define DEFAULT_CORPUS_DIR              "corpus"
+#define EXPECTATION_FILE                "expected.tsv"
+#define DEFAULT_RATE_TOLERANCE          1.0 // in percentage points
+#define DEFAULT_MISREAD_TOLERANCE       0.5 // in percentage points
+#define DEFAULT_TIME_TOLERANCE          0 // ratio to baseline, 0 to skip, since time depends on the machine
+
+typedef struct expectation
+{
+    std::string file;
+    std::string format;
+    std::string text;
+} expectation_t;
+
+typedef struct tally
+{
+    int total;
+    int correct;
+    int misread;
+} tally_t;
+
+typedef struct summary
+{
+    double decode_rate; // in percentage
+    double misread_rate; // in percentage
+    double mean_ms;
+    double p95_ms;
+    std::string machine; // where times are measured, compared before times are
+} summary_t;
+
+typedef struct options
+{
+    std::string corpus_dir;
+    std::string baseline;
+    bool save_baseline;
+    std::string decoders;
+    std::string decode_mode;
+    int localize;
+    bool verbose;
+    double rate_tolerance;
+    double misread_tolerance;
+    double time_tolerance;
+} options_t;
+
+static void usage(const char *prog)
+{
+    printf("Usage: %s [OPTION]...\n"
+        "  -c, --corpus DIR               Directory of corpus, \"%s\" by default.\n"
+        "  -b, --baseline FILE            Compare against the baseline, and fail on regressions.\n"
+        "      --save-baseline            Write results into the baseline file instead of comparing.\n"
+        "      --decoders NAMES           Decoder engines among %s, \"zxing\" by default.\n"
+        "      --decode-mode MODE         cascade or race, cascade by default.\n"
+        "      --localize N               Decode up to N localized candidates only, 0 (disabled) by default.\n"
+        "      --rate-tolerance PP        Max drop of decode rate in percentage points, %.1f by default.\n"
+        "      --misread-tolerance PP     Max rise of misread rate in percentage points, %.1f by default.\n"
+        "      --time-tolerance RATIO     Max ratio of mean time per image to baseline, 0 (skipped) by default,\n"
+        "                                 and skipped as well on a machine other than that of baseline.\n"
+        "  -v, --verbose                  Show failed images.\n"
+        "  -h, --help                     Show this help.\n",
+        prog, DEFAULT_CORPUS_DIR, DECODER_ENGINE_CANDIDATES,
+        DEFAULT_RATE_TOLERANCE, DEFAULT_MISREAD_TOLERANCE);
+}
+
+static int parse_options(int argc, char **argv, options_t &opts)
+{
+    enum
+    {
+        OPT_SAVE_BASELINE = 256,
+        OPT_DECODERS,
+        OPT_DECODE_MODE,
+        OPT_LOCALIZE,
+        OPT_RATE_TOLERANCE,
+        OPT_MISREAD_TOLERANCE,
+        OPT_TIME_TOLERANCE,
+    };
+    const struct option OPTIONS[] = {
+        { "corpus", required_argument, nullptr, 'c' },
+        { "baseline", required_argument, nullptr, 'b' },
+        { "save-baseline", no_argument, nullptr, OPT_SAVE_BASELINE },
+        { "decoders", required_argument, nullptr, OPT_DECODERS },
+        { "decode-mode", required_argument, nullptr, OPT_DECODE_MODE },
+        { "localize", required_argument, nullptr, OPT_LOCALIZE },
+        { "rate-tolerance", required_argument, nullptr, OPT_RATE_TOLERANCE },
+        { "misread-tolerance", required_argument, nullptr, OPT_MISREAD_TOLERANCE },
+        { "time-tolerance", required_argument, nullptr, OPT_TIME_TOLERANCE },
+        { "verbose", no_argument, nullptr, 'v' },
+        { "help", no_argument, nullptr, 'h' },
+        { nullptr, 0, nullptr, 0 }
+    };
+    int opt;
+
+    opts.corpus_dir = DEFAULT_CORPUS_DIR;
+    opts.save_baseline = false;
+    opts.decoders = "zxing";
+    opts.decode_mode = "cascade";
+    opts.localize = 0;
+    opts.verbose = false;
+    opts.rate_tolerance = DEFAULT_RATE_TOLERANCE;
+    opts.misread_tolerance = DEFAULT_MISREAD_TOLERANCE;
+    opts.time_tolerance = DEFAULT_TIME_TOLERANCE;
+
+    while (-1 != (opt = getopt_long(argc, argv, "c:b:vh", OPTIONS, nullptr)))
+    {
+        switch (opt)
+        {
+        case 'c':
+            opts.corpus_dir = optarg;
+            break;
+
+        case 'b':
+            opts.baseline = optarg;
+            break;
+
+        case OPT_SAVE_BASELINE:
+            opts.save_baseline = true;
+            break;
+
+        case OPT_DECODERS:
+            opts.decoders = optarg;
+            break;
+
+        case OPT_DECODE_MODE:
+            opts.decode_mode = optarg;
+            break;
+
+        case OPT_LOCALIZE:
+            opts.localize = atoi(optarg);
+            break;
+
+        case OPT_RATE_TOLERANCE:
+            opts.rate_tolerance = atof(optarg);
+            break;
+
+        case OPT_MISREAD_TOLERANCE:
+            opts.misread_tolerance = atof(optarg);
+            break;
+
+        case OPT_TIME_TOLERANCE:
+            opts.time_tolerance = atof(optarg);
+            break;
+
+        case 'v':
+            opts.verbose = true;
+            break;
+
+        case 'h':
+            usage(argv[0]);
+            exit(EXIT_SUCCESS);
+
+        default:
+            usage(argv[0]);
+            return -EINVAL;
+        }
+    }
+
+    if (opts.save_baseline && opts.baseline.empty())
+    {
+        fprintf(stderr, "*** --save-baseline requires -b or --baseline\n");
+        return -EINVAL;
+    }
+
+    return 0;
+}
+
+static int load_expectations(const std::string &path, std::vector<expectation_t> &expectations)
+{
+    FILE *stream = fopen(path.c_str(), "r");
+    char line[4096];
+
+    if (nullptr == stream)
+    {
+        int err = errno;
+
+        fprintf(stderr, "*** Failed to open %s: %s\n", path.c_str(), strerror(err));
+        return -err;
+    }
+
+    while (nullptr != fgets(line, sizeof(line), stream))
+    {
+        char *file = line;
+        char *format;
+        char *text;
+
+        line[strcspn(line, "\r\n")] = '\0';
+        if ('#' == line[0] || '\0' == line[0])
+            continue;
+
+        if (nullptr == (format = strchr(file, '\t')) || nullptr == (text = strchr(format + 1, '\t')))
+        {
+            fprintf(stderr, "*** Malformed line in %s: %s\n", path.c_str(), line);
+            fclose(stream);
+            return -EINVAL;
+        }
+        *format++ = '\0';
+        *text++ = '\0';
+        expectations.push_back({ file, format, text });
+    }
+
+    fclose(stream);
+
+    return expectations.empty() ? -ENODATA : 0;
+}
+
+// CPU model and count of online CPUs, e.g. "Cortex-A76 x8".
+static std::string describe_machine(void)
+{
+    FILE *stream = fopen("/proc/cpuinfo", "r");
+    char line[256];
+    std::string model = "unknown";
+
+    while (nullptr != stream && nullptr != fgets(line, sizeof(line), stream))
+    {
+        const char *colon = strchr(line, ':');
+
+        // "model name" of x86, or "Hardware" and "CPU part" of ARM, of which the former is preferred.
+        if (nullptr == colon || !(0 == strncmp(line, "model name", 10) || 0 == strncmp(line, "Hardware", 8)
+            || ("unknown" == model && 0 == strncmp(line, "CPU part", 8))))
+            continue;
+
+        model = colon + 1 + strspn(colon + 1, " \t");
+        model.erase(model.find_last_not_of(" \t\r\n") + 1);
+        if (0 != strncmp(line, "CPU part", 8))
+            break;
+    }
+    if (nullptr != stream)
+        fclose(stream);
+
+    return model + " x" + std::to_string(std::thread::hardware_concurrency());
+}
+
+// Baseline is a plain file of "key=value" lines, so that it's easy to review in VCS.
+static int load_baseline(const std::string &path, summary_t &baseline)
+{
+    FILE *stream = fopen(path.c_str(), "r");
+    char line[256];
+    int found = 0;
+
+    if (nullptr == stream)
+    {
+        int err = errno;
+
+        fprintf(stderr, "*** Failed to open baseline %s: %s\n", path.c_str(), strerror(err));
+        return -err;
+    }
+
+    while (nullptr != fgets(line, sizeof(line), stream))
+    {
+        double value;
+
+        if (1 == sscanf(line, "decode_rate=%lf", &value))
+        {
+            baseline.decode_rate = value;
+            found |= 1;
+        }
+        else if (1 == sscanf(line, "misread_rate=%lf", &value))
+        {
+            baseline.misread_rate = value;
+            found |= 2;
+        }
+        else if (1 == sscanf(line, "mean_ms=%lf", &value))
+        {
+            baseline.mean_ms = value;
+            found |= 4;
+        }
+        else if (1 == sscanf(line, "p95_ms=%lf", &value))
+            baseline.p95_ms = value;
+        else if (0 == strncmp(line, "machine=", 8))
+        {
+            baseline.machine = line + 8;
+            baseline.machine.erase(baseline.machine.find_last_not_of("\r\n") + 1);
+        }
+    }
+
+    fclose(stream);
+
+    if (7 != found)
+    {
+        fprintf(stderr, "*** Baseline %s lacks decode_rate, misread_rate or mean_ms\n", path.c_str());
+        return -EINVAL;
+    }
+
+    return 0;
+}
+
+static int save_baseline(const std::string &path, const summary_t &summary)
+{
+    FILE *stream = fopen(path.c_str(), "w");
+
+    if (nullptr == stream)
+    {
+        int err = errno;
+
+        fprintf(stderr, "*** Failed to create baseline %s: %s\n", path.c_str(), strerror(err));
+        return -err;
+    }
+
+    fprintf(stream, "decode_rate=%.2f\nmisread_rate=%.2f\nmean_ms=%.3f\np95_ms=%.3f\nmachine=%s\n",
+        summary.decode_rate, summary.misread_rate, summary.mean_ms, summary.p95_ms, summary.machine.c_str());
+    fclose(stream);
+
+    return 0;
+}
+
+static bool compare_with_baseline(const summary_t &current, const summary_t &baseline, const options_t &opts)
+{
+    bool ok = true;
+
+    if (current.decode_rate < baseline.decode_rate - opts.rate_tolerance)
+    {
+        fprintf(stderr, "*** Decode rate regressed: %.2f%% < %.2f%% - %.2f\n",
+            current.decode_rate, baseline.decode_rate, opts.rate_tolerance);
+        ok = false;
+    }
+
+    if (current.misread_rate > baseline.misread_rate + opts.misread_tolerance)
+    {
+        fprintf(stderr, "*** Misread rate regressed: %.2f%% > %.2f%% + %.2f\n",
+            current.misread_rate, baseline.misread_rate, opts.misread_tolerance);
+        ok = false;
+    }
+
+    if (opts.time_tolerance <= 0)
+        return ok;
+
+    if (current.machine != baseline.machine)
+    {
+        fprintf(stderr, "Throughput is not compared, since baseline is measured on another machine: %s\n",
+            baseline.machine.empty() ? "unknown" : baseline.machine.c_str());
+        return ok;
+    }
+
+    if (current.mean_ms > baseline.mean_ms * opts.time_tolerance)
+    {
+        fprintf(stderr, "*** Throughput regressed: %.3f ms/image > %.3f x %.2f\n",
+            current.mean_ms, baseline.mean_ms, opts.time_tolerance);
+        ok = false;
+    }
+
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    options_t opts;
+    std::vector<expectation_t> expectations;
+    decoder_c decoder;
+    ZXing::DecodeHints hints;
+    std::vector<double> durations_ms;
+    std::map<std::string, tally_t> tallies;
+    tally_t overall = {};
+    int unreadable = 0;
+    summary_t summary;
+    int err;
+
+    if ((err = parse_options(argc, argv, opts)) < 0)
+        return EXIT_FAILURE;
+
+    if ((err = load_expectations(opts.corpus_dir + "/" EXPECTATION_FILE, expectations)) < 0)
+    {
+        if (-ENODATA == err)
+            fprintf(stderr, "*** Corpus is empty, generate it with gen_corpus.elf first\n");
+        return EXIT_FAILURE;
+    }
+
+    if ((err = decoder.init(opts.decoders, opts.decode_mode)) < 0)
+        return EXIT_FAILURE;
+
+    barcode_localizer_c localizer(opts.localize);
+
+    // Same as the images biz of scanner: grayscale input, any format.
+    hints.setFormats(ZXing::BarcodeFormat::Any);
+    durations_ms.reserve(expectations.size());
+
+    for (const auto &item : expectations)
+    {
+        cv::Mat image = cv::imread(opts.corpus_dir + "/" + item.file, cv::IMREAD_GRAYSCALE);
+        tally_t &tally = tallies[item.format];
+
+        if (image.empty())
+        {
+            fprintf(stderr, "*** Failed to read %s/%s\n", opts.corpus_dir.c_str(), item.file.c_str());
+            ++unreadable;
+            continue;
+        }
+
+        // Only decoding is timed, since file I/O is not what this harness watches.
+        auto begin = std::chrono::steady_clock::now();
+        barcode_info_t info = localizer.enabled()
+            ? localizer.decode(image, hints, decoder) : decoder.decode(image, hints);
+        auto end = std::chrono::steady_clock::now();
+
+        durations_ms.push_back(std::chrono::duration<double, std::milli>(end - begin).count());
+        ++tally.total;
+        ++overall.total;
+
+        if (!barcode_info_ok(info))
+        {
+            if (opts.verbose)
+                printf("NOT FOUND: %s\n", item.file.c_str());
+        }
+        else if (info.text == item.text && item.format == ZXing::ToString(info.format))
+        {
+            ++tally.correct;
+            ++overall.correct;
+        }
+        else
+        {
+            ++tally.misread;
+            ++overall.misread;
+            if (opts.verbose)
+            {
+                printf("MISREAD: %s: %s [%s] instead of %s [%s]\n", item.file.c_str(),
+                    info.text.c_str(), ZXing::ToString(info.format), item.text.c_str(), item.format.c_str());
+            }
+        }
+    }
+
+    if (unreadable > 0 || 0 == overall.total)
+    {
+        fprintf(stderr, "*** %d image(s) of corpus unreadable\n", unreadable);
+        return EXIT_FAILURE;
+    }
+
+    std::sort(durations_ms.begin(), durations_ms.end());
+    summary.decode_rate = 100.0 * overall.correct / overall.total;
+    summary.misread_rate = 100.0 * overall.misread / overall.total;
+    summary.mean_ms = 0;
+    for (double ms : durations_ms)
+    {
+        summary.mean_ms += ms;
+    }
+    summary.mean_ms /= durations_ms.size();
+    summary.p95_ms = durations_ms[std::min(durations_ms.size() - 1, durations_ms.size() * 95 / 100)];
+    summary.machine = describe_machine();
+
+    printf("%-16s %8s %8s %8s %8s\n", "Format", "Total", "Correct", "Misread", "Rate");
+    for (const auto &iter : tallies)
+    {
+        const tally_t &tally = iter.second;
+
+        printf("%-16s %8d %8d %8d %7.2f%%\n", iter.first.c_str(), tally.total, tally.correct, tally.misread,
+            100.0 * tally.correct / std::max(tally.total, 1));
+    }
+    printf("%-16s %8d %8d %8d %7.2f%%\n", "(all)", overall.total, overall.correct, overall.misread, summary.decode_rate);
+    printf("Not found: %d, misread rate: %.2f%%, time per image: mean %.3f ms, p95 %.3f ms\n",
+        overall.total - overall.correct - overall.misread, summary.misread_rate, summary.mean_ms, summary.p95_ms);
+
+    if (opts.baseline.empty())
+        return EXIT_SUCCESS;
+
+    if (opts.save_baseline)
+    {
+        if (save_baseline(opts.baseline, summary) < 0)
+            return EXIT_FAILURE;
+
+        printf("Baseline saved into %s\n", opts.baseline.c_str());
+
+        return EXIT_SUCCESS;
+    }
+
+    summary_t baseline = {};
+
+    if (load_baseline(opts.baseline, baseline) < 0)
+        return EXIT_FAILURE;
+
+    if (!compare_with_baseline(summary, baseline, opts))
+        return EXIT_FAILURE;
+
+    printf("No regression against %s\n", opts.baseline.c_str());
+
+    return EXIT_SUCCESS;
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ *  02. Record the machine in baseline, and skip the throughput gate by default or on another machine.
+ */
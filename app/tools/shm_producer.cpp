@@ -0,0 +1,264 @@
+/*
+ * Test producer of the shared-memory frame ring.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <getopt.h>
+
+#include <string>
+
+#include <opencv2/core/mat.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+
+#include "raw_frame.hpp"
+#include "shm_ring.hpp"
+
+#define DEFAULT_NAME                    "/barcode_scanner"
+#define DEFAULT_SLOTS                   4
+#define DEFAULT_FPS                     15.0f
+
+static volatile sig_atomic_t s_stopped = 0;
+
+static void on_signal(int sig)
+{
+    s_stopped = 1;
+}
+
+static void usage(const char *prog)
+{
+    printf("Usage: %s [OPTION]... VIDEO|IMAGE|CAMERA_ID\n"
+        "Publish frames of a video, an image (repeatedly) or a camera into a shared-memory ring,\n"
+        "which can be read by: barcode_scanner.elf -s shm NAME\n"
+        "  -n, --name NAME         Name of shared memory, \"%s\" by default.\n"
+        "  -f, --format FORMAT     Pixel format among {%s}, grey by default.\n"
+        "      --slots COUNT       Slots of ring, %d by default.\n"
+        "      --fps FPS           Frames per second, %.0f by default, 0 for as fast as possible.\n"
+        "      --loop              Restart from the beginning at the end of video.\n"
+        "  -h, --help              Show this help.\n",
+        prog, DEFAULT_NAME, RAW_FORMAT_CANDIDATES, DEFAULT_SLOTS, DEFAULT_FPS);
+}
+
+// Converts BGR frame into packed planes of the format, with rows of the minimum stride.
+static void convert(const cv::Mat &bgr, uint32_t format, cv::Mat &packed)
+{
+    if (RAW_FORMAT_BGR == format)
+    {
+        packed = bgr.isContinuous() ? bgr : bgr.clone();
+        return;
+    }
+
+    if (RAW_FORMAT_GREY == format)
+    {
+        cv::cvtColor(bgr, packed, cv::COLOR_BGR2GRAY);
+        return;
+    }
+
+    // NV12 from I420: luma plane as is, and the two quarter-size chroma planes interleaved.
+    cv::Mat i420;
+    int width = bgr.cols & ~1;
+    int height = bgr.rows & ~1;
+    size_t luma_size = (size_t)width * height;
+    size_t chroma_size = luma_size / 4;
+
+    cv::cvtColor(bgr(cv::Rect(0, 0, width, height)), i420, cv::COLOR_BGR2YUV_I420);
+    packed.create(height * 3 / 2, width, CV_8UC1);
+    memcpy(packed.data, i420.data, luma_size);
+
+    const uint8_t *u = i420.data + luma_size;
+    const uint8_t *v = u + chroma_size;
+    uint8_t *uv = packed.data + luma_size;
+
+    for (size_t i = 0; i < chroma_size; ++i)
+    {
+        uv[2 * i] = u[i];
+        uv[2 * i + 1] = v[i];
+    }
+}
+
+int main(int argc, char **argv)
+{
+    enum
+    {
+        OPT_SLOTS = 256,
+        OPT_FPS,
+        OPT_LOOP,
+    };
+    const struct option OPTIONS[] = {
+        { "name", required_argument, nullptr, 'n' },
+        { "format", required_argument, nullptr, 'f' },
+        { "slots", required_argument, nullptr, OPT_SLOTS },
+        { "fps", required_argument, nullptr, OPT_FPS },
+        { "loop", no_argument, nullptr, OPT_LOOP },
+        { "help", no_argument, nullptr, 'h' },
+        { nullptr, 0, nullptr, 0 }
+    };
+    std::string name = DEFAULT_NAME;
+    uint32_t format = RAW_FORMAT_GREY;
+    int slots = DEFAULT_SLOTS;
+    float fps = DEFAULT_FPS;
+    bool loop = false;
+    int opt;
+
+    while (-1 != (opt = getopt_long(argc, argv, "n:f:h", OPTIONS, nullptr)))
+    {
+        switch (opt)
+        {
+        case 'n':
+            name = optarg;
+            break;
+
+        case 'f':
+            if (0 == (format = raw_format_from_name(optarg)))
+            {
+                fprintf(stderr, "*** Invalid pixel format: %s\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+
+        case OPT_SLOTS:
+            slots = atoi(optarg);
+            break;
+
+        case OPT_FPS:
+            fps = atof(optarg);
+            break;
+
+        case OPT_LOOP:
+            loop = true;
+            break;
+
+        case 'h':
+            usage(argv[0]);
+            return EXIT_SUCCESS;
+
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (optind >= argc || slots < 2 || fps < 0)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const char *input = argv[optind];
+    char *end;
+    long cam_id = strtol(input, &end, 10);
+    cv::VideoCapture vicap;
+
+    if (!(('\0' == *end) ? vicap.open(cam_id) : vicap.open(input)))
+    {
+        fprintf(stderr, "*** Failed to open %s\n", input);
+        return EXIT_FAILURE;
+    }
+
+    cv::Mat bgr;
+    cv::Mat packed;
+
+    if (!vicap.read(bgr) || bgr.empty())
+    {
+        fprintf(stderr, "*** Failed to read the first frame of %s\n", input);
+        return EXIT_FAILURE;
+    }
+
+    // Size of frames is fixed by the first one.
+    shm_ring_c ring;
+    int width = (RAW_FORMAT_NV12 == format) ? (bgr.cols & ~1) : bgr.cols;
+    int height = (RAW_FORMAT_NV12 == format) ? (bgr.rows & ~1) : bgr.rows;
+    size_t stride = raw_frame_min_stride(format, width);
+    uint64_t published = 0;
+    uint64_t busy = 0;
+
+    if (ring.create(name, slots, raw_frame_size(format, width, height, stride), fps) < 0)
+        return EXIT_FAILURE;
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    fprintf(stderr, "Publishing %dx%d %s frames into %s, press Ctrl+C to stop\n",
+        width, height, raw_format_name(format), name.c_str());
+
+    struct timespec due;
+
+    clock_gettime(CLOCK_MONOTONIC, &due);
+
+    while (!s_stopped)
+    {
+        if (bgr.cols < width || bgr.rows < height)
+        {
+            fprintf(stderr, "*** Frame size changed to %dx%d\n", bgr.cols, bgr.rows);
+            break;
+        }
+
+        convert(bgr(cv::Rect(0, 0, width, height)), format, packed);
+
+        int err = ring.publish(format, width, height, stride, packed.data);
+
+        if (0 == err)
+            ++published;
+        else if (-EBUSY == err)
+            ++busy; // all slots held by consumers, frame dropped
+        else
+        {
+            fprintf(stderr, "*** Failed to publish frame: %s\n", strerror(-err));
+            break;
+        }
+
+        if (fps > 0)
+        {
+            long interval_ns = (long)(1e9 / fps);
+
+            due.tv_nsec += interval_ns % 1000000000;
+            due.tv_sec += interval_ns / 1000000000 + due.tv_nsec / 1000000000;
+            due.tv_nsec %= 1000000000;
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, nullptr);
+        }
+
+        if (vicap.read(bgr) && !bgr.empty())
+            continue;
+
+        // An image, or the end of video.
+        if (1 == vicap.get(cv::CAP_PROP_FRAME_COUNT) || loop)
+        {
+            vicap.set(cv::CAP_PROP_POS_FRAMES, 0);
+            if (vicap.read(bgr) && !bgr.empty())
+                continue;
+        }
+        break;
+    }
+
+    fprintf(stderr, "%llu frames published, %llu dropped as all slots were busy\n",
+        (unsigned long long)published, (unsigned long long)busy);
+
+    return EXIT_SUCCESS;
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-19, Man Hung-Coeng <udc577@126.com>:
+ *  01. Create.
+ */